@@ -2,14 +2,27 @@
 #include <stdint.h>
 #include <cstdlib>
 #include <iostream>
+#include <string>
 #include <vector>
 #include "MicroBench.h"
 #include "MemEstimator.h"
 #include "timing/ClockSync.h"
 #include "timing/elg_pform_defs.h"
+#include "timing/EventTrace.h"
+#include "timing/SyncValidationBench.h"
 #include "collectives/CollectivesBench.h"
 #include "collectives/CommMemBench.h"
+#include "collectives/NonblockingCollectivesBench.h"
+#include "collectives/PersistentCollectivesBench.h"
+#include "collectives/NeighborCollectivesBench.h"
+#include "collectives/InterCollectivesBench.h"
+#include "collectives/SubcommCollectivesBench.h"
+#include "collectives/ThreadedCollectivesBench.h"
 #include "overheads/OverheadsBench.h"
+#include "noise/NoiseBench.h"
+#include "pt2pt/PartitionedBench.h"
+#include "pt2pt/PointToPointBench.h"
+#include "pt2pt/MatchingQueueBench.h"
 
 
 #ifdef USE_SCOREP
@@ -25,26 +38,56 @@ SCOREP_USER_METRIC_LOCAL (bench_memory_metric);
 int main (int argc, char** argv) {
 	
     // Get the command arguments/
-    // The command argument is the message size per process
+    // The command argument is the message size per process, the optional
+    // second one the benchmark suite to run
     bool is_extra_msg_size_bench = false;
-    unsigned int message_size_per_proc = 0;
+    uint64_t message_size_per_proc = 0;
     bool duplicate_world_comm = false;
     if (argc < 2) {
         return -1;
     }
+    std::string bench_suite = (argc > 2) ? argv[2] : "default";
     //is_extra_msg_size_bench = (std::atoi(argv[1]) == 1);
-    message_size_per_proc = std::atoi(argv[1]);
+    message_size_per_proc = std::strtoull(argv[1], NULL, 10);
     //duplicate_world_comm = (std::atoi(argv[3]) == 1);
     
 	// General init steps
 	CMSB::elg_pform_init ();
     
     CMSB::TimeSyncInfo timeSyncInfo;
+    
+    // Select how ranks wait for the synchronized start: "spin" (default),
+    // "relaxed" or "both" to run every benchmark with each of them
+    std::vector<CMSB::SyncWaitMode> wait_modes;
+    const char* wait_mode_env = std::getenv ("CMSB_SYNC_WAIT");
+    std::string wait_mode_str = (wait_mode_env != NULL) ? wait_mode_env : "spin";
+    if (wait_mode_str == "spin" || wait_mode_str == "both")
+        wait_modes.push_back (CMSB::SYNC_WAIT_SPIN);
+    if (wait_mode_str == "relaxed" || wait_mode_str == "both")
+        wait_modes.push_back (CMSB::SYNC_WAIT_RELAXED);
+
+    // Select the roots of the rooted collectives in the "root" suite:
+    // "rotate" (default), "sweep", "fixed:<k>" or "random:<n>"
+    const char* root_policy_env = std::getenv ("CMSB_ROOT_POLICY");
+    std::string root_policy_str = (root_policy_env != NULL) ? root_policy_env : "rotate";
+    CMSB::RootPolicy root_policy;
+    bool root_policy_ok = CMSB::RootPolicy::parse (root_policy_str, root_policy);
+
+    // Threads per rank of the "threads" and "partitioned" suites
+    const char* num_threads_env = std::getenv ("CMSB_NUM_THREADS");
+    int num_threads = (num_threads_env != NULL) ? std::atoi (num_threads_env) : 4;
 	
 	// Measure initial memory consumption
 	uint64_t initial_proc_mem = CMSB::MemEstimator::getProcMemConsumption ();
     
-    MPI_Init (&argc, &argv);
+    // Only the threaded suites pay for the full thread support
+    if (bench_suite == "threads" || bench_suite == "partitioned") {
+        int provided;
+        MPI_Init_thread (&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+    }
+    else {
+        MPI_Init (&argc, &argv);
+    }
 
 #ifdef USE_SCOREP    
     SCOREP_USER_METRIC_INIT (bench_memory_metric, "Memory", "bytes",
@@ -55,28 +98,131 @@ int main (int argc, char** argv) {
 
     MPI_Comm_rank (MPI_COMM_WORLD, &my_rank);
     MPI_Comm_size (MPI_COMM_WORLD, &num_procs);
+
+    if (wait_modes.empty ()) {
+        if (my_rank == 0) {
+            std::cerr << "Unknown sync wait mode: " << wait_mode_str << " (spin|relaxed|both)" << std::endl;
+        }
+        MPI_Finalize ();
+        return -1;
+    }
+    if (!root_policy_ok || !root_policy.isValid (num_procs)) {
+        if (my_rank == 0) {
+            std::cerr << "Unknown root policy: " << root_policy_str << " (rotate|sweep|fixed:<k>|random:<n>, k < "
+                      << num_procs << ")" << std::endl;
+        }
+        MPI_Finalize ();
+        return -1;
+    }
+    if (num_threads < 1) {
+        if (my_rank == 0) {
+            std::cerr << "Invalid thread count: " << num_threads_env << " (CMSB_NUM_THREADS >= 1)" << std::endl;
+        }
+        MPI_Finalize ();
+        return -1;
+    }
     
 	// Create benchmarks
 	std::vector<CMSB::MicroBench*> benchmarks;
     if (is_extra_msg_size_bench) {
         //CMSB::createCollectiveExtraSizeMicroBenches (benchmarks, message_size_per_proc);
     }
-    else {
+    else if (bench_suite == "default") {
         //CMSB::createCollectiveMicroBenches (benchmarks, message_size_per_proc);
         CMSB::createCollectiveMicroBenchesMinimalVer (benchmarks, message_size_per_proc);
         //benchmarks.push_back (new CMSB::CommMemBench ());
+        CMSB::createOverheadsMicroBenches (benchmarks);
+    }
+    else if (bench_suite == "full") {
+        CMSB::createCollectiveMicroBenches (benchmarks, message_size_per_proc);
+    }
+    else if (bench_suite == "arrival") {
+        CMSB::createArrivalPatternMicroBenches (benchmarks, message_size_per_proc);
+    }
+    else if (bench_suite == "datatype") {
+        CMSB::createDatatypeMicroBenches (benchmarks, message_size_per_proc);
+    }
+    else if (bench_suite == "op") {
+        CMSB::createReductionOpMicroBenches (benchmarks, message_size_per_proc);
+    }
+    else if (bench_suite == "large") {
+        CMSB::createLargeCountMicroBenches (benchmarks, message_size_per_proc);
+    }
+    else if (bench_suite == "inplace") {
+        CMSB::createInPlaceMicroBenches (benchmarks, message_size_per_proc);
+    }
+    else if (bench_suite == "irregular") {
+        CMSB::createIrregularCountMicroBenches (benchmarks, message_size_per_proc);
+    }
+    else if (bench_suite == "root") {
+        CMSB::createRootPolicyMicroBenches (benchmarks, message_size_per_proc, root_policy);
+    }
+    else if (bench_suite == "nbc") {
+        CMSB::createNonblockingCollectiveMicroBenches (benchmarks, message_size_per_proc);
+    }
+    else if (bench_suite == "persistent") {
+        CMSB::createPersistentCollectiveMicroBenches (benchmarks, message_size_per_proc);
+    }
+    else if (bench_suite == "neighbor") {
+        CMSB::createNeighborCollectiveMicroBenches (benchmarks, message_size_per_proc);
+    }
+    else if (bench_suite == "inter") {
+        CMSB::createInterCollectiveMicroBenches (benchmarks, message_size_per_proc);
+    }
+    else if (bench_suite == "subcomm") {
+        CMSB::createSubcommCollectiveMicroBenches (benchmarks, message_size_per_proc);
+    }
+    else if (bench_suite == "threads") {
+        CMSB::createThreadedCollectiveMicroBenches (benchmarks, message_size_per_proc, num_threads);
+    }
+    else if (bench_suite == "pt2pt") {
+        CMSB::createPointToPointMicroBenches (benchmarks, message_size_per_proc);
+    }
+    else if (bench_suite == "matching") {
+        CMSB::createMatchingQueueMicroBenches (benchmarks);
+    }
+    else if (bench_suite == "partitioned") {
+        CMSB::createPartitionedMicroBenches (benchmarks, message_size_per_proc, num_threads);
+    }
+    else if (bench_suite == "noise") {
+        // The noise benchmark runs last to see the outliers of the collectives
+        CMSB::createCollectiveMicroBenchesMinimalVer (benchmarks, message_size_per_proc);
+        CMSB::createNoiseMicroBenches (benchmarks);
+    }
+    else {
+        if (my_rank == 0) {
+            std::cerr << "Unknown benchmark suite: " << bench_suite << std::endl;
+        }
+        MPI_Finalize ();
+        return -1;
     }
-    CMSB::createOverheadsMicroBenches (benchmarks);
 
+    // Memory held by the clock synchronization
+    CMSB::MemEstimator::startLocalPeakMemMeasurement ();
     CMSB::sync_init_stage1 (&timeSyncInfo);
+    uint64_t sync_mem = CMSB::MemEstimator::getLocalPeakMemConsumption ();
+    uint64_t max_sync_mem = 0;
+    MPI_Reduce (&sync_mem, &max_sync_mem, 1, MPI_UINT64_T, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    // Record a timeline of the syncs and measurements if a trace file is given
+    const char* trace_file = std::getenv ("CMSB_TRACE_FILE");
+    if (trace_file != NULL) {
+        CMSB::trace_init (MPI_COMM_WORLD, trace_file);
+    }
             
     if (my_rank == 0) {
         std::cout << "Running benchmarks..." << std::endl;
         std::cout << "Extra message size bench: " << is_extra_msg_size_bench << std::endl;
+        std::cout << "Benchmark suite: " << bench_suite << std::endl;
         std::cout << "Max buffer size in: " << MAX_BUFF_SIZE_PER_PROC << " MB" << std::endl;
         std::cout << "Message size per process in doubles: " << message_size_per_proc << std::endl;
         std::cout << "Non comm-world communicator: " << duplicate_world_comm << std::endl;
+        std::cout << "Sync wait mode: " << wait_mode_str << std::endl;
+        std::cout << "Root policy: " << root_policy_str << std::endl;
+        std::cout << "Threads per rank: " << num_threads << std::endl;
+        std::cout << "Event trace file: " << ((trace_file != NULL) ? trace_file : "none") << std::endl;
         std::cout << "Running on " << num_procs << " ranks" << std::endl; 
+        std::cout << "Clock sync peak memory consumption (bytes): " << max_sync_mem << std::endl;
         std::cout << "Memory consumption before allocating buffers " 
 				  << CMSB::MemEstimator::getCurrentMemConsumption () << std::endl;
     }
@@ -84,14 +230,14 @@ int main (int argc, char** argv) {
 	unsigned int num_benchmarks = benchmarks.size ();
 	
 	CMSB::MicroBench::MicroBenchInfo benchInfo;
-	unsigned int buff_size = (MAX_BUFF_SIZE_PER_PROC * 1024 * 1024) / sizeof(double);
+	uint64_t buff_size = ((uint64_t)MAX_BUFF_SIZE_PER_PROC * 1024 * 1024) / sizeof(double);
     benchInfo._sBuffLen = benchInfo._rBuffLen = buff_size * sizeof(double);
 	benchInfo._sendBuff = new double[buff_size];
 	benchInfo._recvBuff = new double[buff_size];
-	benchInfo._sendCounts = new int[num_procs];
-	benchInfo._sendDispls = new int[num_procs];
-	benchInfo._recvCounts = new int[num_procs];
-	benchInfo._recvDispls = new int[num_procs];
+	benchInfo._sendCounts = new CMSB::VCount[num_procs];
+	benchInfo._sendDispls = new CMSB::VDispl[num_procs];
+	benchInfo._recvCounts = new CMSB::VCount[num_procs];
+	benchInfo._recvDispls = new CMSB::VDispl[num_procs];
     
     if (my_rank == 0) {
 		std::cout << "Memory consumption after allocating buffers " 
@@ -106,6 +252,12 @@ int main (int argc, char** argv) {
     std::fill_n (benchInfo._recvCounts, num_procs, 0);
     std::fill_n (benchInfo._recvDispls, num_procs, 0);
     
+    // Check the accuracy of the clock sync right after it and then
+    // regularly during the campaign
+    CMSB::SyncValidationBench sync_validation;
+    sync_validation.init (MPI_COMM_WORLD, &benchInfo);
+    sync_validation.runMicroBench (&timeSyncInfo);
+    
     // Duplicate comm-world communicator
     MPI_Comm dup_world_comm = MPI_COMM_WORLD;
     if (duplicate_world_comm) {
@@ -117,17 +269,23 @@ int main (int argc, char** argv) {
     
    	// Init & run benchmarks
    	for (int i = 0; i < num_benchmarks; i++) {
-		if (my_rank == 0) {
-			std::cout << "Starting benchmark: " << benchmarks[i]->getMicroBenchName () << std::endl;
+		for (size_t m = 0; m < wait_modes.size (); m++) {
+			timeSyncInfo._waitMode = wait_modes[m];
+			if (my_rank == 0) {
+				std::cout << "Starting benchmark: " << benchmarks[i]->getMicroBenchName () << std::endl;
+			}
+			// Re-init buffers
+			std::fill_n (benchInfo._sendBuff, buff_size, my_rank+1);	// +1 so that rank's zero buff contains ones instead of zeros
+			std::fill_n (benchInfo._recvBuff, buff_size, 0.0);
+			benchmarks[i]->init (dup_world_comm, &benchInfo);
+			benchmarks[i]->runMicroBench (&timeSyncInfo);
+			benchmarks[i]->writeResultToProfile ();
+			if (my_rank == 0) {
+				std::cout << "Benchmark: " << benchmarks[i]->getMicroBenchName () << " finished." << std::endl;
+			}
 		}
-		// Re-init buffers
-		std::fill_n (benchInfo._sendBuff, buff_size, my_rank+1);	// +1 so that rank's zero buff contains ones instead of zeros
-		std::fill_n (benchInfo._recvBuff, buff_size, 0.0);
-		benchmarks[i]->init (dup_world_comm, &benchInfo);
-		benchmarks[i]->runMicroBench (&timeSyncInfo);
-		benchmarks[i]->writeResultToProfile ();
-		if (my_rank == 0) {
-			std::cout << "Benchmark: " << benchmarks[i]->getMicroBenchName () << " finished." << std::endl;
+		if ((i+1) % CMSB::SyncValidationBench::CHECK_INTERVAL == 0 || i+1 == int (num_benchmarks)) {
+			sync_validation.runMicroBench (&timeSyncInfo);
 		}
    	}   
 	
@@ -135,7 +293,8 @@ int main (int argc, char** argv) {
 	uint64_t proc_mem = CMSB::MemEstimator::getProcMemConsumption () - initial_proc_mem;
 	uint64_t mpi_mem = CMSB::MemEstimator::getPeakMemConsumption ();
 	uint64_t overheads = CMSB::MemEstimator::getBenchesMemConsumption (benchmarks);
-	overheads += sizeof(double)*2*buff_size + sizeof(int)*4*num_procs;
+	overheads += sizeof(double)*2*buff_size + (sizeof(CMSB::VCount) + sizeof(CMSB::VDispl))*2*num_procs;
+	overheads += CMSB::trace_get_mem_consumption ();
 	mpi_mem -= overheads;
 	proc_mem -= overheads;
     
@@ -152,6 +311,9 @@ int main (int argc, char** argv) {
         CMSB::MemEstimator::printSmapsFile ();
     }
 	
+    CMSB::trace_write ();
+    CMSB::sync_finalize (&timeSyncInfo);
+
     if (duplicate_world_comm) {
         MPI_Comm_free (&dup_world_comm);
     }
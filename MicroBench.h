@@ -2,10 +2,21 @@
 #define __MICRO_BENCH_H__
 
 #include <mpi.h>
+#include <stdint.h>
 #include "timing/ClockSync.h"
 
 namespace CMSB {
 
+#if MPI_VERSION >= 4
+	// Counts and displacements of the v-collectives - 64 bit for their
+	// large-count bindings
+	typedef MPI_Count	VCount;
+	typedef MPI_Aint	VDispl;
+#else
+	typedef int			VCount;
+	typedef int			VDispl;
+#endif
+
 	class MicroBench {
 
 	public:    
@@ -21,13 +32,13 @@ namespace CMSB {
 				_recvDispls (NULL) {}
 			
 			double* _sendBuff;
-            unsigned int _sBuffLen;     // In bytes
+            uint64_t _sBuffLen;         // In bytes
 			double* _recvBuff;
-            unsigned int _rBuffLen;     // In bytes
-			int*	_sendCounts;
-			int*	_sendDispls;
-			int*	_recvCounts;
-			int*	_recvDispls;
+            uint64_t _rBuffLen;         // In bytes
+			VCount*	_sendCounts;
+			VDispl*	_sendDispls;
+			VCount*	_recvCounts;
+			VDispl*	_recvDispls;
 		};
 
 		MicroBench  () : _worldComm (MPI_COMM_WORLD) {}
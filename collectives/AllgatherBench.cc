@@ -15,7 +15,7 @@ SCOREP_USER_METRIC_LOCAL (bench_AllgatherBench_metric);
 #endif
 
 
-CMSB::AllgatherBench::AllgatherBench (unsigned int messageSize) {
+CMSB::AllgatherBench::AllgatherBench (uint64_t messageSize) {
 
     _msgSize = messageSize;
 }
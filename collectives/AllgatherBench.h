@@ -14,7 +14,7 @@ namespace CMSB {
 
 	public:
 
-		AllgatherBench  (unsigned int messageSize);
+		AllgatherBench  (uint64_t messageSize);
 		virtual ~AllgatherBench ();
 		
 		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
@@ -15,7 +15,7 @@ SCOREP_USER_METRIC_LOCAL (bench_AllgathervBench_metric);
 #endif
 
 
-CMSB::AllgathervBench::AllgathervBench (unsigned int messageSize) {
+CMSB::AllgathervBench::AllgathervBench (uint64_t messageSize) {
 
     _msgSize = messageSize;
 }
@@ -14,12 +14,13 @@ namespace CMSB {
 
 	public:
 
-		AllgathervBench  (unsigned int messageSize);
+		AllgathervBench  (uint64_t messageSize);
 		virtual ~AllgathervBench ();
 		
 		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
         virtual const char* getMicroBenchName () const;
 		virtual void writeResultToProfile () const;
+		virtual bool usesVCounts () const { return true; }
 
 	protected:
 		virtual void performMPICollectiveFunc ();
@@ -15,7 +15,7 @@ SCOREP_USER_METRIC_LOCAL (bench_AllreduceBench_metric);
 #endif
 
 
-CMSB::AllreduceBench::AllreduceBench (unsigned int messageSize) {
+CMSB::AllreduceBench::AllreduceBench (uint64_t messageSize) {
 
     _msgSize = messageSize;
 }
@@ -14,7 +14,7 @@ namespace CMSB {
 
 	public:
 
-		AllreduceBench  (unsigned int messageSize);
+		AllreduceBench  (uint64_t messageSize);
 		virtual ~AllreduceBench ();
 		
 		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
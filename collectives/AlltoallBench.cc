@@ -15,7 +15,7 @@ SCOREP_USER_METRIC_LOCAL (bench_AlltoallBench_metric);
 #endif
 
 
-CMSB::AlltoallBench::AlltoallBench (unsigned int messageSize) {
+CMSB::AlltoallBench::AlltoallBench (uint64_t messageSize) {
 
     _msgSize = messageSize;
 }
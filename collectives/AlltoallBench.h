@@ -14,7 +14,7 @@ namespace CMSB {
 
 	public:
 
-		AlltoallBench  (unsigned int messageSize);
+		AlltoallBench  (uint64_t messageSize);
 		virtual ~AlltoallBench ();
 		
 		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
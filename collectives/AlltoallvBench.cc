@@ -15,7 +15,7 @@ SCOREP_USER_METRIC_LOCAL (bench_AlltoallvBench_metric);
 #endif
 
 
-CMSB::AlltoallvBench::AlltoallvBench (unsigned int messageSize) {
+CMSB::AlltoallvBench::AlltoallvBench (uint64_t messageSize) {
 
     _msgSize = messageSize;
 }
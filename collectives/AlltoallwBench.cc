@@ -0,0 +1,80 @@
+#include <mpi.h>
+#include <algorithm>
+#include "AlltoallwBench.h"
+
+#ifdef USE_SCOREP
+#include <scorep/SCOREP_User.h>
+#endif
+
+
+
+
+//======================================================================
+
+#ifdef USE_SCOREP
+SCOREP_USER_METRIC_LOCAL (bench_AlltoallwBench_metric);
+#endif
+
+
+CMSB::AlltoallwBench::AlltoallwBench (uint64_t messageSize) {
+
+    _msgSize = messageSize;
+}
+
+CMSB::AlltoallwBench::~AlltoallwBench () {
+}
+
+void CMSB::AlltoallwBench::init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo) {
+
+	CMSB::CollectivesBench::init (worldComm, benchInfo);
+	MPI_Aint lb, extent;
+	MPI_Type_get_extent (_datatype, &lb, &extent);
+	_sendByteDispls.resize (_numProcs);
+	_recvByteDispls.resize (_numProcs);
+	_types.resize (_numProcs);
+	// The displacements are in bytes, they overflow int before the
+	// counts do - only before MPI 4
+	int overflow = 0;
+#if MPI_VERSION < 4
+	int64_t send_bytes = 0, recv_bytes = 0;
+	for (int i = 0; i < _numProcs; i++) {
+		send_bytes = std::max (send_bytes, ((int64_t)_benchInfo._sendDispls[i] + _benchInfo._sendCounts[i]) * extent);
+		recv_bytes = std::max (recv_bytes, ((int64_t)_benchInfo._recvDispls[i] + _benchInfo._recvCounts[i]) * extent);
+	}
+	int local_overflow = (std::max (send_bytes, recv_bytes) > INT_MAX);
+	MPI_Allreduce (&local_overflow, &overflow, 1, MPI_INT, MPI_MAX, _worldComm);
+	_countOverflow = _countOverflow || overflow;
+#endif
+	for (int i = 0; i < _numProcs; i++) {
+		_sendByteDispls[i] = overflow ? 0 : (CMSB::VDispl)_benchInfo._sendDispls[i] * extent;
+		_recvByteDispls[i] = overflow ? 0 : (CMSB::VDispl)_benchInfo._recvDispls[i] * extent;
+		_types[i] = _datatype;
+	}
+#ifdef USE_SCOREP
+    SCOREP_USER_METRIC_INIT (bench_AlltoallwBench_metric, "Alltoallw timing", "usec",
+                             SCOREP_USER_METRIC_TYPE_DOUBLE, SCOREP_USER_METRIC_CONTEXT_GLOBAL);
+#endif
+}
+
+const char* CMSB::AlltoallwBench::getMicroBenchName () const {
+
+    return "MPI_Alltoallw";
+}
+
+void CMSB::AlltoallwBench::writeResultToProfile () const {
+
+#ifdef USE_SCOREP
+	if (_myRank == 0) {		// Only one rank should update SCORE-P's metrics
+		SCOREP_USER_METRIC_DOUBLE (bench_AlltoallwBench_metric, getMicroBenchResult ());
+	}
+#endif
+}
+
+void CMSB::AlltoallwBench::performMPICollectiveFunc () {
+
+    V_COUNT_CALL (Alltoallw, (getSendBuff (), _benchInfo._sendCounts, &_sendByteDispls[0], &_types[0],
+                              _benchInfo._recvBuff, _benchInfo._recvCounts, &_recvByteDispls[0], &_types[0],
+                              _worldComm));
+}
+
+//======================================================================
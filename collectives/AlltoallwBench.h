@@ -0,0 +1,39 @@
+#ifndef __Alltoallw_BENCH_H__
+#define __Alltoallw_BENCH_H__
+
+
+#include <vector>
+#include "CollectivesBench.h"
+
+
+namespace CMSB {
+
+	/**
+	 * Represents Alltoallw benchmark. The blocks follow the counts of
+	 * Alltoallv, so the result is comparable with Alltoall and Alltoallv.
+	 */
+	class AlltoallwBench : public CMSB::CollectivesBench {
+
+	public:
+
+		AlltoallwBench  (uint64_t messageSize);
+		virtual ~AlltoallwBench ();
+		
+		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
+        virtual const char* getMicroBenchName () const;
+		virtual void writeResultToProfile () const;
+		virtual bool usesVCounts () const { return true; }
+
+	protected:
+		virtual void performMPICollectiveFunc ();
+
+		// Alltoallw takes displacements in bytes
+		std::vector<CMSB::VDispl>	_sendByteDispls;
+		std::vector<CMSB::VDispl>	_recvByteDispls;
+		std::vector<MPI_Datatype>	_types;
+	};
+	
+}
+
+
+#endif   // __Alltoallw_BENCH_H__
@@ -0,0 +1,63 @@
+#include <cmath>
+#include "ArrivalPattern.h"
+
+
+
+CMSB::ArrivalPattern::ArrivalPattern (Type type, double delayFactor, unsigned int seed) :
+	_type			(type),
+	_delayFactor	(delayFactor),
+	_seed			(seed),
+	_myRank			(0),
+	_numProcs		(1),
+	_maxDelay		(0.0),
+	_randState		(1) {
+
+}
+
+void CMSB::ArrivalPattern::init (int myRank, int numProcs, double estTime) {
+
+	_myRank = myRank;
+	_numProcs = numProcs;
+	_maxDelay = (_type == NONE) ? 0.0 : _delayFactor * estTime;
+	// Every rank draws its own, but reproducible, sequence
+	_randState = (_seed + 7919U * (unsigned int)myRank) % 2147483646U + 1;
+}
+
+double CMSB::ArrivalPattern::nextDelay (int root) {
+
+	switch (_type) {
+		case ONE_LATE:
+			return (_myRank == _numProcs-1) ? _maxDelay : 0.0;
+		case LINEAR_SKEW:
+			return (_numProcs > 1) ? _maxDelay * _myRank / (_numProcs-1) : 0.0;
+		case RANDOM_UNIFORM:
+			return _maxDelay * nextRandom ();
+		case RANDOM_EXPONENTIAL: {
+			double delay = -std::log (1.0 - nextRandom ()) * _maxDelay / 4.0;
+			return (delay > _maxDelay) ? _maxDelay : delay;
+		}
+		case LATE_ROOT:
+			return (_myRank == root) ? _maxDelay : 0.0;
+		default:
+			return 0.0;
+	}
+}
+
+const char* CMSB::ArrivalPattern::getName () const {
+
+	switch (_type) {
+		case ONE_LATE:				return "one_late";
+		case LINEAR_SKEW:			return "linear_skew";
+		case RANDOM_UNIFORM:		return "random_uniform";
+		case RANDOM_EXPONENTIAL:	return "random_exponential";
+		case LATE_ROOT:				return "late_root";
+		default:					return "none";
+	}
+}
+
+double CMSB::ArrivalPattern::nextRandom () {
+
+	// Park-Miller minimal standard generator - the state stays in [1, 2^31-2]
+	_randState = (unsigned int)((16807ULL * _randState) % 2147483647U);
+	return (_randState - 1) / 2147483646.0;
+}
@@ -0,0 +1,50 @@
+#ifndef __ARRIVAL_PATTERN_H__
+#define __ARRIVAL_PATTERN_H__
+
+
+namespace CMSB {
+
+	/**
+	 * Per-rank delays added to the synchronized start of a collective, so
+	 * that the ranks arrive at it unevenly. The delays are given as a
+	 * multiple of the estimated runtime of the collective. The collective
+	 * is then timed from the last arrival to the last completion.
+	 */
+	class ArrivalPattern {
+
+	public:
+
+		enum Type {
+			NONE,					// All ranks start at the same time
+			ONE_LATE,				// The last rank is late by the full delay
+			LINEAR_SKEW,			// Rank i is late by i/(P-1) of the delay
+			RANDOM_UNIFORM,			// Uniform random delay in [0, delay] per iteration
+			RANDOM_EXPONENTIAL,		// Exponential random delay with mean delay/4,
+									// cut off at the delay, per iteration
+			LATE_ROOT				// The root is late by the full delay
+		};
+
+		ArrivalPattern (Type type = NONE, double delayFactor = 1.0, unsigned int seed = 1);
+
+		void init (int myRank, int numProcs, double estTime);
+		double nextDelay (int root);
+		double getMaxDelay () const { return _maxDelay; }
+		Type getType () const { return _type; }
+		const char* getName () const;
+
+	protected:
+		double nextRandom ();
+
+		Type			_type;
+		double			_delayFactor;
+		unsigned int	_seed;
+		int				_myRank;
+		int				_numProcs;
+		double			_maxDelay;		// In usec
+		unsigned int	_randState;
+	};
+
+}
+
+
+#endif   // __ARRIVAL_PATTERN_H__
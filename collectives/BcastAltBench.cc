@@ -15,7 +15,7 @@
 SCOREP_USER_METRIC_LOCAL (bench_BcastAltBench_metric);
 #endif
 
-CMSB::BcastAltBench::BcastAltBench (unsigned int messageSize) {
+CMSB::BcastAltBench::BcastAltBench (uint64_t messageSize) {
 
     _msgSize = messageSize;
 }
@@ -26,6 +26,8 @@ CMSB::BcastAltBench::~BcastAltBench () {
 void CMSB::BcastAltBench::init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo) {
 
 	CMSB::CollectivesBench::init (worldComm, benchInfo);
+	// The messages of the tree are plain doubles with an int count
+	_countOverflow = (_msgSize > INT_MAX);
 #ifdef USE_SCOREP
     SCOREP_USER_METRIC_INIT (bench_BcastAltBench_metric, "BcastAlt timing", "usec",
                              SCOREP_USER_METRIC_TYPE_DOUBLE, SCOREP_USER_METRIC_CONTEXT_GLOBAL);
@@ -49,7 +51,7 @@ void CMSB::BcastAltBench::writeResultToProfile () const {
 void CMSB::BcastAltBench::performMPICollectiveFunc () {
 	
 	// Alternative implementation of MPI_Bcast.
-	// Invoked as: MPI_Bcast (_benchInfo._sendBuff, _msgSize, MPI_DOUBLE, 0, _worldComm)
+	// Invoked as: MPI_Bcast (_benchInfo._sendBuff, _msgSize, MPI_DOUBLE, _root, _worldComm)
 	// The idea is to use MST implementation to get a clear expectation how much time
 	// the bcast operation will take. The expected model is: T = log(P)*[alpha+N*beta],
 	// where p - number of processes, N - message size in bytes, alpha - latency, and beta -
@@ -60,7 +62,7 @@ void CMSB::BcastAltBench::performMPICollectiveFunc () {
 	// This algorithm assumes the message size is relative small. For bigger messages better
 	// algorithms exist.
 	
-	bcastAltImpl (0, 0, _numProcs-1);
+	bcastAltImpl (_root, 0, _numProcs-1);
 	
 	// Check for correctness of the operation - every rank should have the root's buffer, which
 	// contains ones
@@ -14,7 +14,7 @@ namespace CMSB {
 
 	public:
 
-		BcastAltBench  (unsigned int messageSize);
+		BcastAltBench  (uint64_t messageSize);
 		virtual ~BcastAltBench ();
 		
 		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
@@ -15,7 +15,7 @@ SCOREP_USER_METRIC_LOCAL (bench_BcastBench_metric);
 #endif
 
 
-CMSB::BcastBench::BcastBench (unsigned int messageSize) {
+CMSB::BcastBench::BcastBench (uint64_t messageSize) {
 
     _msgSize = messageSize;
 }
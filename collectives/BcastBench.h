@@ -14,7 +14,7 @@ namespace CMSB {
 
 	public:
 
-		BcastBench  (unsigned int messageSize);
+		BcastBench  (uint64_t messageSize);
 		virtual ~BcastBench ();
 		
 		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
@@ -0,0 +1,170 @@
+#include <climits>
+#include <vector>
+#include "BenchDatatype.h"
+
+
+// Length of the blocks of the indexed type, a gap of one double follows
+#define INDEXED_BLOCK_LEN 2
+
+
+CMSB::BenchDatatype::BenchDatatype (Kind kind) :
+	_kind		(kind),
+	_type		(MPI_DOUBLE),
+	_count		(0),
+	_largeCount	(false) {
+
+}
+
+CMSB::BenchDatatype::BenchDatatype (const BenchDatatype& other) :
+	_kind		(other._kind),
+	_type		(MPI_DOUBLE),
+	_count		(0),
+	_largeCount	(false) {
+
+}
+
+CMSB::BenchDatatype& CMSB::BenchDatatype::operator= (const BenchDatatype& other) {
+
+	if (this != &other) {
+		free ();
+		_kind = other._kind;
+	}
+	return *this;
+}
+
+CMSB::BenchDatatype::~BenchDatatype () {
+
+	free ();
+}
+
+void CMSB::BenchDatatype::commit (uint64_t numDoubles) {
+
+	uint64_t num_bytes = numDoubles * sizeof (double);
+
+	free ();
+	if (numDoubles == 0) return;
+	switch (_kind) {
+		case FLOAT:
+			_type = MPI_FLOAT;
+			_count = num_bytes / sizeof (float);
+			break;
+		case INT:
+			_type = MPI_INT;
+			_count = num_bytes / sizeof (int);
+			break;
+		case LONG_LONG:
+			_type = MPI_LONG_LONG;
+			_count = num_bytes / sizeof (long long);
+			break;
+		case DOUBLE_COMPLEX:
+			_type = MPI_C_DOUBLE_COMPLEX;
+			_count = num_bytes / (2 * sizeof (double));
+			break;
+		case DOUBLE_INT: {
+			struct { double value; int index; } pair;
+			_type = MPI_DOUBLE_INT;
+			_count = num_bytes / sizeof (pair);
+			break;
+		}
+		case VECTOR:
+			if (numDoubles > INT_MAX) {
+				commitUnits (1, 2, numDoubles);
+				break;
+			}
+			MPI_Type_vector (numDoubles, 1, 2, MPI_DOUBLE, &_type);
+			MPI_Type_commit (&_type);
+			_count = 1;
+			break;
+		case INDEXED: {
+			// The displacements reach 1.5 times the doubles - beyond int
+			// an odd last double is left out
+			if (numDoubles / INDEXED_BLOCK_LEN * (INDEXED_BLOCK_LEN+1) > INT_MAX) {
+				commitUnits (INDEXED_BLOCK_LEN, INDEXED_BLOCK_LEN+1, numDoubles / INDEXED_BLOCK_LEN);
+				break;
+			}
+			int num_blocks = (numDoubles + INDEXED_BLOCK_LEN-1) / INDEXED_BLOCK_LEN;
+			std::vector<int> lengths (num_blocks, INDEXED_BLOCK_LEN);
+			std::vector<int> displs (num_blocks);
+			for (int i = 0; i < num_blocks; i++) displs[i] = i * (INDEXED_BLOCK_LEN+1);
+			lengths[num_blocks-1] = numDoubles - (num_blocks-1) * INDEXED_BLOCK_LEN;
+			MPI_Type_indexed (num_blocks, &lengths[0], &displs[0], MPI_DOUBLE, &_type);
+			MPI_Type_commit (&_type);
+			_count = 1;
+			break;
+		}
+		default:
+			_type = MPI_DOUBLE;
+			_count = numDoubles;
+			break;
+	}
+#if MPI_VERSION < 4
+	if (_count > INT_MAX) commitLargeCount ();
+#endif
+}
+
+void CMSB::BenchDatatype::commitLargeCount () {
+
+	// Full chunks and the remainder in a struct, so that the count needs
+	// no divisor that fits an int
+	MPI_Aint lb, extent;
+	MPI_Type_get_extent (_type, &lb, &extent);
+	int num_chunks = _count / LARGE_COUNT_CHUNK;
+	int remainder = _count % LARGE_COUNT_CHUNK;
+	MPI_Datatype element = _type, chunks, rest;
+	MPI_Type_vector (num_chunks, LARGE_COUNT_CHUNK, LARGE_COUNT_CHUNK, element, &chunks);
+	MPI_Type_contiguous (remainder, element, &rest);
+	int lengths[2] = { 1, 1 };
+	MPI_Aint displs[2] = { 0, (MPI_Aint)num_chunks * LARGE_COUNT_CHUNK * extent };
+	MPI_Datatype types[2] = { chunks, rest };
+	MPI_Type_create_struct (2, lengths, displs, types, &_type);
+	MPI_Type_commit (&_type);
+	MPI_Type_free (&chunks);
+	MPI_Type_free (&rest);
+	// The struct keeps what it needs of a derived element type
+	if (isDerived ()) MPI_Type_free (&element);
+	_count = 1;
+	_largeCount = true;
+}
+
+void CMSB::BenchDatatype::commitUnits (int blockLen, int stride, uint64_t numUnits) {
+
+	// A block and its gap as the element - beyond int the count of them
+	// goes to the large-count path like the one of a basic type
+	MPI_Datatype block;
+	MPI_Type_contiguous (blockLen, MPI_DOUBLE, &block);
+	MPI_Type_create_resized (block, 0, (MPI_Aint)stride * sizeof (double), &_type);
+	MPI_Type_commit (&_type);
+	MPI_Type_free (&block);
+	_count = numUnits;
+}
+
+MPI_Aint CMSB::BenchDatatype::getExtent () const {
+
+	MPI_Aint lb, extent;
+	MPI_Type_get_extent (_type, &lb, &extent);
+	return _count * extent;
+}
+
+const char* CMSB::BenchDatatype::getName () const {
+
+	switch (_kind) {
+		case FLOAT:				return "float";
+		case INT:				return "int";
+		case LONG_LONG:			return "long_long";
+		case DOUBLE_COMPLEX:	return "double_complex";
+		case DOUBLE_INT:		return "double_int";
+		case VECTOR:			return "vector";
+		case INDEXED:			return "indexed";
+		default:				return "double";
+	}
+}
+
+void CMSB::BenchDatatype::free () {
+
+	if ((isDerived () || _largeCount) && _type != MPI_DOUBLE && _type != MPI_DATATYPE_NULL) {
+		MPI_Type_free (&_type);
+	}
+	_type = MPI_DOUBLE;
+	_count = 0;
+	_largeCount = false;
+}
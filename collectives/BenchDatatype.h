@@ -0,0 +1,71 @@
+#ifndef __BENCH_DATATYPE_H__
+#define __BENCH_DATATYPE_H__
+
+
+#include <mpi.h>
+#include <stdint.h>
+
+
+namespace CMSB {
+
+	/**
+	 * The datatype a collective moves. A message always has the byte size
+	 * of the given number of doubles - the basic types change the element
+	 * count, the derived types scatter the doubles over a larger extent.
+	 * Reductions are only defined on the basic types. Without the
+	 * large-count bindings of MPI 4, counts beyond int are packed into
+	 * one element of a contiguous type.
+	 */
+	class BenchDatatype {
+
+	public:
+
+		enum Kind {
+			DOUBLE,
+			FLOAT,
+			INT,
+			LONG_LONG,
+			DOUBLE_COMPLEX,		// MPI_C_DOUBLE_COMPLEX
+			DOUBLE_INT,			// MPI_DOUBLE_INT pairs for MINLOC and MAXLOC
+			VECTOR,				// Every other double, MPI_Type_vector
+			INDEXED				// Pairs of doubles with gaps, MPI_Type_indexed
+		};
+
+		// Elements per chunk of the contiguous type of large counts
+		static const int LARGE_COUNT_CHUNK = 1 << 30;
+
+		BenchDatatype (Kind kind = DOUBLE);
+		// Copies only the kind - the type is built by commit ()
+		BenchDatatype (const BenchDatatype& other);
+		BenchDatatype& operator= (const BenchDatatype& other);
+		~BenchDatatype ();
+
+		// Builds the type for messages of numDoubles doubles
+		void commit (uint64_t numDoubles);
+		MPI_Datatype getType () const { return _type; }
+		MPI_Count getCount () const { return _count; }
+		// Bytes between the starts of two consecutive messages
+		MPI_Aint getExtent () const;
+		Kind getKind () const { return _kind; }
+		bool isDerived () const { return _kind == VECTOR || _kind == INDEXED; }
+		// The basic type packed into one element for a count beyond int
+		bool isLargeCount () const { return _largeCount; }
+		const char* getName () const;
+
+	protected:
+		void free ();
+		void commitLargeCount ();
+		// numUnits blocks of blockLen doubles, stride doubles apart - the
+		// derived types for counts or displacements beyond int
+		void commitUnits (int blockLen, int stride, uint64_t numUnits);
+
+		Kind			_kind;
+		MPI_Datatype	_type;
+		MPI_Count		_count;
+		bool			_largeCount;
+	};
+
+}
+
+
+#endif   // __BENCH_DATATYPE_H__
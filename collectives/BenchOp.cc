@@ -0,0 +1,134 @@
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "BenchOp.h"
+
+
+// Element-wise sum of doubles as a code would write it
+static void user_sum (void* in, void* inout, int* len, MPI_Datatype*) {
+
+	double* a = (double*)in;
+	double* b = (double*)inout;
+	for (int i = 0; i < *len; i++) {
+		b[i] += a[i];
+	}
+}
+
+// The same with explicit vector instructions, the remainder is scalar
+static void user_sum_simd (void* in, void* inout, int* len, MPI_Datatype*) {
+
+	double* a = (double*)in;
+	double* b = (double*)inout;
+	int i = 0;
+#if defined(__AVX__)
+	for (; i + 4 <= *len; i += 4) {
+		_mm256_storeu_pd (b + i, _mm256_add_pd (_mm256_loadu_pd (a + i), _mm256_loadu_pd (b + i)));
+	}
+#elif defined(__SSE2__)
+	for (; i + 2 <= *len; i += 2) {
+		_mm_storeu_pd (b + i, _mm_add_pd (_mm_loadu_pd (a + i), _mm_loadu_pd (b + i)));
+	}
+#endif
+	for (; i < *len; i++) {
+		b[i] += a[i];
+	}
+}
+
+// MPI_SUM on the contiguous type of large counts of doubles
+static void large_count_sum (void* in, void* inout, int* len, MPI_Datatype* type) {
+
+	double* a = (double*)in;
+	double* b = (double*)inout;
+	MPI_Count size;
+	MPI_Type_size_x (*type, &size);
+	MPI_Count num_doubles = *len * (size / sizeof (double));
+	for (MPI_Count i = 0; i < num_doubles; i++) {
+		b[i] += a[i];
+	}
+}
+
+
+CMSB::BenchOp::BenchOp (Kind kind) :
+	_kind		(kind),
+	_op			(MPI_SUM),
+	_largeCount	(false) {
+
+}
+
+CMSB::BenchOp::BenchOp (const BenchOp& other) :
+	_kind		(other._kind),
+	_op			(MPI_SUM),
+	_largeCount	(false) {
+
+}
+
+CMSB::BenchOp& CMSB::BenchOp::operator= (const BenchOp& other) {
+
+	if (this != &other) {
+		free ();
+		_kind = other._kind;
+	}
+	return *this;
+}
+
+CMSB::BenchOp::~BenchOp () {
+
+	free ();
+}
+
+void CMSB::BenchOp::commit (const CMSB::BenchDatatype& type) {
+
+	free ();
+	if (type.isLargeCount () && _kind == SUM && type.getKind () == CMSB::BenchDatatype::DOUBLE) {
+		MPI_Op_create (large_count_sum, 1, &_op);
+		_largeCount = true;
+		return;
+	}
+	switch (_kind) {
+		case MAX:			_op = MPI_MAX;		break;
+		case MIN:			_op = MPI_MIN;		break;
+		case PROD:			_op = MPI_PROD;		break;
+		case BOR:			_op = MPI_BOR;		break;
+		case MINLOC:		_op = MPI_MINLOC;	break;
+		case MAXLOC:		_op = MPI_MAXLOC;	break;
+		case USER_SUM:		MPI_Op_create (user_sum, 1, &_op);		break;
+		case USER_SUM_SIMD:	MPI_Op_create (user_sum_simd, 1, &_op);	break;
+		default:			_op = MPI_SUM;		break;
+	}
+}
+
+CMSB::BenchDatatype::Kind CMSB::BenchOp::getDatatypeKind () const {
+
+	switch (_kind) {
+		case BOR:		return CMSB::BenchDatatype::LONG_LONG;
+		case MINLOC:
+		case MAXLOC:	return CMSB::BenchDatatype::DOUBLE_INT;
+		default:		return CMSB::BenchDatatype::DOUBLE;
+	}
+}
+
+const char* CMSB::BenchOp::getName () const {
+
+	switch (_kind) {
+		case MAX:			return "max";
+		case MIN:			return "min";
+		case PROD:			return "prod";
+		case BOR:			return "bor";
+		case MINLOC:		return "minloc";
+		case MAXLOC:		return "maxloc";
+		case USER_SUM:		return "user_sum";
+		case USER_SUM_SIMD:	return "user_sum_simd";
+		default:			return "sum";
+	}
+}
+
+void CMSB::BenchOp::free () {
+
+	if ((_kind == USER_SUM || _kind == USER_SUM_SIMD || _largeCount) && _op != MPI_SUM && _op != MPI_OP_NULL) {
+		MPI_Op_free (&_op);
+	}
+	_op = MPI_SUM;
+	_largeCount = false;
+}
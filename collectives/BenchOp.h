@@ -0,0 +1,59 @@
+#ifndef __BENCH_OP_H__
+#define __BENCH_OP_H__
+
+
+#include <mpi.h>
+#include "BenchDatatype.h"
+
+
+namespace CMSB {
+
+	/**
+	 * The operation a reduction applies. Besides the predefined operations
+	 * there are two user-defined sums on doubles: a plain loop as a code
+	 * would write it and one with explicit SIMD, to compare both with the
+	 * built-in kernel of MPI_SUM. On the contiguous type of large counts
+	 * MPI_SUM of doubles is replaced by a user-defined sum, the predefined
+	 * operations are only defined on the basic types.
+	 */
+	class BenchOp {
+
+	public:
+
+		enum Kind {
+			SUM,
+			MAX,
+			MIN,
+			PROD,
+			BOR,			// On MPI_LONG_LONG
+			MINLOC,			// On MPI_DOUBLE_INT pairs
+			MAXLOC,
+			USER_SUM,		// MPI_Op_create, plain loop
+			USER_SUM_SIMD	// MPI_Op_create, explicit SIMD
+		};
+
+		BenchOp (Kind kind = SUM);
+		// Copies only the kind - user operations are created by commit ()
+		BenchOp (const BenchOp& other);
+		BenchOp& operator= (const BenchOp& other);
+		~BenchOp ();
+
+		void commit (const CMSB::BenchDatatype& type);
+		MPI_Op getOp () const { return _op; }
+		Kind getKind () const { return _kind; }
+		// The datatype the operation is defined on
+		CMSB::BenchDatatype::Kind getDatatypeKind () const;
+		const char* getName () const;
+
+	protected:
+		void free ();
+
+		Kind	_kind;
+		MPI_Op	_op;
+		bool	_largeCount;
+	};
+
+}
+
+
+#endif   // __BENCH_OP_H__
@@ -7,7 +7,14 @@
 #include <iostream>
 #include <ios>
 #include <iomanip>
+#include <map>
+#include <sstream>
 #include <timing/elg_pform_defs.h>
+#include <timing/EventTrace.h>
+#include <timing/SyncRounds.h>
+#include <util/NodeMap.h>
+#include <util/Statistics.h>
+#include <MemEstimator.h>
 #include "AlltoallBench.h"
 #include "AllgatherBench.h"
 #include "AllreduceBench.h"
@@ -25,6 +32,10 @@
 #include "GathervBench.h"
 #include "ScattervBench.h"
 #include "BarrierBench.h"
+#include "ExscanBench.h"
+#include "ReduceLocalBench.h"
+#include "ReduceScatterBlockBench.h"
+#include "AlltoallwBench.h"
 
 
 
@@ -32,7 +43,16 @@ CMSB::CollectivesBench::CollectivesBench () :
     _myRank     (0),
     _numProcs   (0),
     _avgRunTime (0.0),
-    _msgSize    (0) {
+    _msgSize    (0),
+    _count      (0),
+    _datatype   (MPI_DOUBLE),
+    _op         (MPI_SUM),
+    _baseline   (NULL),
+    _inPlace    (false),
+    _peakMem    (0),
+    _countOverflow (false),
+    _root       (0),
+    _roundIter  (-1) {
 		
 }
 
@@ -47,24 +67,135 @@ void CMSB::CollectivesBench::init (MPI_Comm worldComm, CMSB::MicroBench::MicroBe
     MPI_Comm_rank (_worldComm, &_myRank);
     MPI_Comm_size (_worldComm, &_numProcs);
     
+    _benchType.commit (_msgSize);
+    _datatype = _benchType.getType ();
+    _count = _benchType.getCount ();
+    _benchOp.commit (_benchType);
+    _op = _benchOp.getOp ();
+    _countDist.init (_numProcs, _count);
+    _blockCounts.resize (_numProcs);
+    _blockDispls.resize (_numProcs);
+    int64_t send_total = 0, recv_total = 0, block_total = 0;
     for (int i = 0; i < _numProcs; i++) {
-		_benchInfo._sendCounts[i] = _msgSize;
-		_benchInfo._sendDispls[i] = i*_msgSize;
-		_benchInfo._recvCounts[i] = _msgSize;
-		_benchInfo._recvDispls[i] = i*_msgSize;
+		_benchInfo._sendCounts[i] = _countDist.getCount (_myRank, i);
+		_benchInfo._sendDispls[i] = send_total;
+		send_total += _countDist.getCount (_myRank, i);
+		_benchInfo._recvCounts[i] = _countDist.getCount (i, _myRank);
+		_benchInfo._recvDispls[i] = recv_total;
+		recv_total += _countDist.getCount (i, _myRank);
+		_blockCounts[i] = _countDist.getBlockCount (i);
+		_blockDispls[i] = block_total;
+		block_total += _countDist.getBlockCount (i);
     }
+    // Buffer lengths from the totals - the root of Scatter(v) sends and
+    // the root of Gather(v) receives all blocks. The extent of a derived
+    // type exceeds its payload, so also the regular counts are checked.
+    MPI_Aint lb, extent;
+    MPI_Type_get_extent (_datatype, &lb, &extent);
+    uint64_t send_len = std::max (send_total, block_total) * extent;
+    uint64_t recv_len = std::max (recv_total, block_total) * extent;
+    // The v-collectives take int counts and displacements before MPI 4 -
+    // beyond that they are not run and get no buffers, the counts are
+    // zeroed
+    _countOverflow = false;
+#if MPI_VERSION < 4
+    int local_overflow = (std::max (std::max (send_total, recv_total), block_total) > INT_MAX);
+    int overflow = 0;
+    MPI_Allreduce (&local_overflow, &overflow, 1, MPI_INT, MPI_MAX, _worldComm);
+    _countOverflow = (overflow && usesVCounts ());
+    if (overflow) {
+		std::fill_n (_benchInfo._sendCounts, _numProcs, 0);
+		std::fill_n (_benchInfo._sendDispls, _numProcs, 0);
+		std::fill_n (_benchInfo._recvCounts, _numProcs, 0);
+		std::fill_n (_benchInfo._recvDispls, _numProcs, 0);
+		std::fill (_blockCounts.begin (), _blockCounts.end (), 0);
+		std::fill (_blockDispls.begin (), _blockDispls.end (), 0);
+    }
+#endif
+    
+    _rootPolicy.init (_numProcs);
+    _root = _rootPolicy.getRoot (0);
+    if (_rootPolicy.getType () != CMSB::RootPolicy::FIXED || _root != 0) {
+		CMSB::gatherRankNodes (_worldComm, _rankNodes);
+    }
+    
+    if (!_countOverflow) {
+		reserveBuffers (send_len, recv_len);
+    }
+}
+
+void CMSB::CollectivesBench::reserveBuffers (uint64_t sendLen, uint64_t recvLen) {
+
+	if (sendLen > _benchInfo._sBuffLen) {
+		_sendBuff.assign (sendLen / sizeof (double) + 1, _myRank+1);
+		_benchInfo._sendBuff = &_sendBuff[0];
+		_benchInfo._sBuffLen = sendLen;
+	}
+	if (recvLen > _benchInfo._rBuffLen) {
+		_recvBuff.assign (recvLen / sizeof (double) + 1, 0.0);
+		_benchInfo._recvBuff = &_recvBuff[0];
+		_benchInfo._rBuffLen = recvLen;
+	}
+}
+
+const double CMSB::CollectivesBench::OUTLIER_FACTOR = 2.0;
+int CMSB::CollectivesBench::_numOutliers = 0;
+std::vector<int> CMSB::CollectivesBench::_stragglerCounts;
+
+std::string CMSB::CollectivesBench::getResultLabel () const {
+
+	std::string label (getMicroBenchName ());
+	if (_benchType.getKind () != CMSB::BenchDatatype::DOUBLE) {
+		label += std::string ("[") + _benchType.getName () + "]";
+	}
+	if (_benchOp.getKind () != CMSB::BenchOp::SUM) {
+		label += std::string ("[") + _benchOp.getName () + "]";
+	}
+	if (_arrivalPattern.getType () != CMSB::ArrivalPattern::NONE) {
+		label += std::string ("[") + _arrivalPattern.getName () + "]";
+	}
+	if (_countDist.getType () != CMSB::CountDistribution::REGULAR) {
+		label += std::string ("[") + _countDist.getName () + "]";
+	}
+	if (_inPlace) {
+		label += "[in_place]";
+	}
+	if (_rootPolicy.getType () == CMSB::RootPolicy::ROTATE) {
+		label += std::string ("[") + _rootPolicy.getName () + "]";
+	}
+	else if (_root != 0) {
+		std::ostringstream root_label;
+		root_label << "[root " << _root << "]";
+		label += root_label.str ();
+	}
+	return label;
+}
+
+bool CMSB::CollectivesBench::skipOnCountOverflow () {
+
+	if (!_countOverflow) return false;
+	if (_myRank == 0) {
+		std::cout << getResultLabel () << ": warning: the counts exceed int, skipped" << std::endl;
+	}
+	_avgRunTime = 0.0;
+	return true;
 }
 
 void CMSB::CollectivesBench::runMicroBench (CMSB::TimeSyncInfo* syncInfo) {
 
 	double start_time, end_time;
-	std::string mpi_collective_name (getMicroBenchName ());
+	std::string mpi_collective_name (getResultLabel ());
+
+	if (skipOnCountOverflow ()) return;
 
 	// First run the warmpup runs - no need to measure times
 	double warmup_times[NUM_WARMPUP_ITERS];
 	double avg_warmup_time = 0.0;
 	double max_warmup_time = 0.0;
 	
+	// Temporary buffers of the library show up in the peak of the
+	// warmups, the first call included
+	CMSB::MemEstimator::startLocalPeakMemMeasurement ();
 	for (int i = 0; i < NUM_WARMPUP_ITERS; i++) {
 		MPI_Barrier (_worldComm);
 		start_time = CMSB::elg_pform_wtime ();
@@ -72,10 +203,14 @@ void CMSB::CollectivesBench::runMicroBench (CMSB::TimeSyncInfo* syncInfo) {
 		end_time = CMSB::elg_pform_wtime ();
 		warmup_times[i] = (end_time - start_time) * 1e6;	// Convert to usec
 	}
+	uint64_t peak_mem = CMSB::MemEstimator::getLocalPeakMemConsumption ();
+	MPI_Reduce (&peak_mem, &_peakMem, 1, MPI_UINT64_T, MPI_MAX, 0, _worldComm);
 	for (int i = 0; i < NUM_WARMPUP_ITERS; i++) avg_warmup_time += warmup_times[i];
 	avg_warmup_time /= NUM_WARMPUP_ITERS;
 	MPI_Allreduce (&avg_warmup_time, &max_warmup_time, 1, MPI_DOUBLE, MPI_MAX, _worldComm);
-	syncInfo->_esttime = max_warmup_time;
+	// The window has to cover the latest arrival, too
+	_arrivalPattern.init (_myRank, _numProcs, max_warmup_time);
+	syncInfo->_esttime = max_warmup_time + _arrivalPattern.getMaxDelay ();
 	
 #ifdef __bgq__
 	// On JUQUEEN it's possible to query the protocol that was used in
@@ -88,13 +223,30 @@ void CMSB::CollectivesBench::runMicroBench (CMSB::TimeSyncInfo* syncInfo) {
 	}
 #endif
 
-	double run_times[NUM_ITERS_ROUND];
+	double run_times[NUM_ITERS_ROUND], kept_run_times[NUM_ITERS_ROUND];
 	double max_run_times[NUM_ITERS_TOTAL];
-	double errors[NUM_ITERS_ROUND];
-	double max_errors[NUM_ITERS_ROUND];
-	int total_num_valid_runs = 0;
+	// Arrival and completion in global time - with an arrival pattern
+	// the collective is timed from the last arrival
+	double arrivals[NUM_ITERS_ROUND], last_arrivals[NUM_ITERS_ROUND];
+	double completions[NUM_ITERS_ROUND];
+	// Completion in global time with the rank in MPI_COMM_WORLD - the
+	// last rank to complete is the straggler of the iteration. The entry
+	// is fixed by the sync slot.
+	struct { double time; int rank; } exits[NUM_ITERS_ROUND], last_exits[NUM_ITERS_ROUND];
+	int stragglers[NUM_ITERS_TOTAL];
+	int world_rank, world_size;
+	MPI_Comm_rank (MPI_COMM_WORLD, &world_rank);
+	MPI_Comm_size (MPI_COMM_WORLD, &world_size);
+	// Root of every iteration - they only differ with a rotating root
+	int roots[NUM_ITERS_ROUND];
+	int iter_roots[NUM_ITERS_TOTAL];
+	int num_iters = 0;
+	_localRunTimes.clear ();
+	_roundIter = -1;
 		
-	do {
+	CMSB::SyncRounds rounds (_worldComm, syncInfo, NUM_ITERS_ROUND, NUM_ITERS_TOTAL);
+	while (rounds.nextRound ()) {
+		int total_num_valid_runs = rounds.getNumKept ();
 		if (_myRank == 0) {
 			std::cout << mpi_collective_name << ": starting new round; valid runs = "
 					  << total_num_valid_runs
@@ -102,47 +254,55 @@ void CMSB::CollectivesBench::runMicroBench (CMSB::TimeSyncInfo* syncInfo) {
 					  << ", est. time = " << std::setprecision(6) << std::fixed << syncInfo->_esttime
 					  << std::endl;
 		}
-		int error_count = 0;
-		CMSB::sync_init_stage2 (syncInfo);
 		for (int i = 0; i < NUM_ITERS_ROUND; i++) {
 			double err = 0;
    
-			errors[i] = CMSB::nbcb_sync (syncInfo);
+			_root = roots[i] = _rootPolicy.getRoot (num_iters++);
+			_roundIter = i;
+			syncInfo->_arrivalDelay = _arrivalPattern.nextDelay (_root) * 1e-6;	// Convert to sec
+			rounds.sync (i);
         
 			start_time = CMSB::elg_pform_wtime ();
 			performMPICollectiveFunc ();
 			end_time = CMSB::elg_pform_wtime ();
+			CMSB::trace_event (mpi_collective_name.c_str (), "collective", start_time, end_time);
 		
 			run_times[i] = (end_time - start_time) * 1e6;	// Convert to usec
+			arrivals[i] = CMSB::sync_local_to_global (start_time);
+			completions[i] = CMSB::sync_local_to_global (end_time);
+			exits[i].time = completions[i];
+			exits[i].rank = world_rank;
 		}
 		
-		// Check for errors in the synchronization process
-		MPI_Allreduce (errors, max_errors, NUM_ITERS_ROUND, MPI_DOUBLE, MPI_MAX, _worldComm);
-		for (int i = 0; i < NUM_ITERS_ROUND; i++) {
-			if (max_errors[i] > 0.0) {
-				error_count++;
-				run_times[i] = run_times[NUM_ITERS_ROUND-error_count];
+		if (_arrivalPattern.getType () != CMSB::ArrivalPattern::NONE) {
+			// The own time of an early rank includes the wait for the late
+			// ones - the maximum is the last completion after the last
+			// arrival instead, comparable between the patterns
+			MPI_Allreduce (arrivals, last_arrivals, NUM_ITERS_ROUND, MPI_DOUBLE, MPI_MAX, _worldComm);
+			for (int i = 0; i < NUM_ITERS_ROUND; i++) {
+				run_times[i] = (completions[i] - last_arrivals[i]) * 1e6;	// Convert to usec
 			}
 		}
-		// If more than 25% erros occured or there are less than 4 valid
-		// measurements, we should double the window size and re-run the
-		// round
-		int valid_runs_count = NUM_ITERS_ROUND-error_count;
-		if (error_count > NUM_ITERS_ROUND*0.25 || valid_runs_count < 4) {
-			syncInfo->_window *= 2.0;
-			continue;
-		}
+		MPI_Reduce (exits, last_exits, NUM_ITERS_ROUND, MPI_DOUBLE_INT, MPI_MAXLOC, 0, _worldComm);
+		// Check for errors in the synchronization process
+		if (!rounds.endRound ()) continue;
 		
-		// Use only the amount of runs needed to complete the NUM_ITERS_TOTAL
-		// requirement
-		if (total_num_valid_runs + valid_runs_count > NUM_ITERS_TOTAL) {
-			valid_runs_count = NUM_ITERS_TOTAL - total_num_valid_runs;
+		// The valid iterations in order, only as many as are still needed
+		const std::vector<int>& kept_iters = rounds.getKeptIters ();
+		int valid_runs_count = kept_iters.size ();
+		for (int i = 0; i < valid_runs_count; i++) {
+			kept_run_times[i] = run_times[kept_iters[i]];
+			stragglers[total_num_valid_runs+i] = last_exits[kept_iters[i]].rank;
+			iter_roots[total_num_valid_runs+i] = roots[kept_iters[i]];
 		}
-		MPI_Reduce (run_times, max_run_times+total_num_valid_runs, valid_runs_count, MPI_DOUBLE, MPI_MAX, 0, _worldComm);
-		total_num_valid_runs += valid_runs_count;
+		MPI_Reduce (kept_run_times, max_run_times+total_num_valid_runs, valid_runs_count, MPI_DOUBLE, MPI_MAX, 0, _worldComm);
+		_localRunTimes.insert (_localRunTimes.end (), kept_run_times, kept_run_times + valid_runs_count);
+		keepIterations (&kept_iters[0], valid_runs_count);
 		
 		// Iterate until sufficient statistical confidence is reached
-	} while (total_num_valid_runs < NUM_ITERS_TOTAL);
+	}
+	syncInfo->_arrivalDelay = 0.0;
+	_roundIter = -1;
 	
 	// Calculate average
 	if (_myRank == 0) {
@@ -150,9 +310,15 @@ void CMSB::CollectivesBench::runMicroBench (CMSB::TimeSyncInfo* syncInfo) {
 		for (int i = 0; i < NUM_ITERS_TOTAL; i++) _avgRunTime += max_run_times[i];
 		_avgRunTime /= NUM_ITERS_TOTAL;
 		std::cout << mpi_collective_name << ": total runs = " << NUM_ITERS_TOTAL << std::endl;
+		std::cout << mpi_collective_name << ": sync error rate = " << std::setprecision(6)
+				  << std::fixed << double (rounds.getNumErrors ()) / rounds.getNumSyncs ()
+				  << " (wait mode: " << ((syncInfo->_waitMode == CMSB::SYNC_WAIT_RELAXED) ? "relaxed" : "spin")
+				  << ")" << std::endl;
 		std::cout << mpi_collective_name << ": average runtime = " << std::setprecision(6)
 				  << std::fixed << _avgRunTime << std::endl;
 		//////////////
+		double run_times_by_iter[NUM_ITERS_TOTAL];
+		std::copy (max_run_times, max_run_times + NUM_ITERS_TOTAL, run_times_by_iter);
 		double median = 0.0;
 		std::sort (max_run_times, max_run_times + NUM_ITERS_TOTAL);
 		if (NUM_ITERS_TOTAL % 2 > 0) {
@@ -166,6 +332,19 @@ void CMSB::CollectivesBench::runMicroBench (CMSB::TimeSyncInfo* syncInfo) {
 		_avgRunTime = median;
 		std::cout << mpi_collective_name << ": median = " << std::setprecision(6)
 				  << std::fixed << median << std::endl;
+		// Remember who was late in the outliers - the noise benchmark
+		// correlates this with the noise of the ranks
+		int num_outliers = 0;
+		_stragglerCounts.resize (world_size, 0);
+		for (int i = 0; i < NUM_ITERS_TOTAL; i++) {
+			if (run_times_by_iter[i] > OUTLIER_FACTOR * median) {
+				num_outliers++;
+				_stragglerCounts[stragglers[i]]++;
+			}
+		}
+		_numOutliers += num_outliers;
+		std::cout << mpi_collective_name << ": outliers = " << num_outliers << std::endl;
+		std::cout << mpi_collective_name << ": peak memory (bytes) = " << _peakMem << std::endl;
 		//////////////
 		double sum = 0.0, sum_of_sqrs = 0.0;
 		for (int i = 0; i < NUM_ITERS_TOTAL; i++) {
@@ -181,18 +360,63 @@ void CMSB::CollectivesBench::runMicroBench (CMSB::TimeSyncInfo* syncInfo) {
 					  << std::fixed << max_run_times[i] << std::endl;
 		}
 		//////////////
+		if (_rootPolicy.getType () == CMSB::RootPolicy::ROTATE) {
+			printRootBreakdown (mpi_collective_name, run_times_by_iter, iter_roots);
+		}
+		else if (_root != 0) {
+			std::cout << mpi_collective_name << ": root node = " << _rankNodes[_root] << std::endl;
+		}
+		if (_baseline != NULL && _baseline->isLocalReduction ()) {
+			// The part of the collective spent in the local reduction
+			std::cout << mpi_collective_name << ": reduction share = " << std::setprecision(6)
+					  << std::fixed << _baseline->getMicroBenchResult () / median << std::endl;
+		}
+		else if (_baseline != NULL) {
+			// Above 1 where the type or operation misses the fast path
+			std::cout << mpi_collective_name << ": relative to " << _baseline->getResultLabel ()
+					  << " = " << std::setprecision(6) << std::fixed
+					  << median / _baseline->getMicroBenchResult () << std::endl;
+			std::cout << mpi_collective_name << ": peak memory over " << _baseline->getResultLabel ()
+					  << " (bytes) = " << (int64_t)(_peakMem - _baseline->_peakMem) << std::endl;
+		}
 	}
 
 }
 
-void CMSB::createCollectiveMicroBenches (std::vector<MicroBench*>& benchmarks, unsigned int messageSizePerProc) {
+void CMSB::CollectivesBench::printRootBreakdown (const std::string& label, const double* runTimes, const int* roots) const {
+	
+	// Median of the iterations at every root and at every node
+	std::map<int, std::vector<double> > root_times, node_times;
+	for (int i = 0; i < NUM_ITERS_TOTAL; i++) {
+		root_times[roots[i]].push_back (runTimes[i]);
+		node_times[_rankNodes[roots[i]]].push_back (runTimes[i]);
+	}
+	for (std::map<int, std::vector<double> >::iterator it = root_times.begin (); it != root_times.end (); ++it) {
+		std::cout << label << ": root " << it->first << " (node " << _rankNodes[it->first] << ") median = "
+				  << std::setprecision(6) << std::fixed << median (it->second) << std::endl;
+	}
+	for (std::map<int, std::vector<double> >::iterator it = node_times.begin (); it != node_times.end (); ++it) {
+		std::cout << label << ": root node " << it->first << " median = "
+				  << std::setprecision(6) << std::fixed << median (it->second) << std::endl;
+	}
+}
+
+void CMSB::createCollectiveMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc) {
 	
+	// Local computation baseline for the reductions - runs before them
+	CMSB::CollectivesBench* reduce_local = new CMSB::ReduceLocalBench (messageSizePerProc);
+	CMSB::CollectivesBench* allreduce = new CMSB::AllreduceBench (messageSizePerProc);
+	CMSB::CollectivesBench* reduce = new CMSB::ReduceBench (messageSizePerProc);
+	allreduce->setBaseline (reduce_local);
+	reduce->setBaseline (reduce_local);
+
 	// Latency-oriented benchmarks
 	benchmarks.push_back (new CMSB::AlltoallBench	  (messageSizePerProc));
 	benchmarks.push_back (new CMSB::AllgatherBench	  (messageSizePerProc));
-	benchmarks.push_back (new CMSB::AllreduceBench	  (messageSizePerProc));
+	benchmarks.push_back (reduce_local);
+	benchmarks.push_back (allreduce);
 	benchmarks.push_back (new CMSB::GatherBench		  (messageSizePerProc));
-	benchmarks.push_back (new CMSB::ReduceBench		  (messageSizePerProc));
+	benchmarks.push_back (reduce);
 	benchmarks.push_back (new CMSB::BcastBench		  (messageSizePerProc));
 	benchmarks.push_back (new CMSB::ScatterBench	  (messageSizePerProc));
 	benchmarks.push_back (new CMSB::ScanBench		  (messageSizePerProc));
@@ -202,9 +426,12 @@ void CMSB::createCollectiveMicroBenches (std::vector<MicroBench*>& benchmarks, u
 	benchmarks.push_back (new CMSB::GathervBench	  (messageSizePerProc));
 	benchmarks.push_back (new CMSB::ScattervBench	  (messageSizePerProc));
 	benchmarks.push_back (new CMSB::BarrierBench   	  ());
+	benchmarks.push_back (new CMSB::ExscanBench		  (messageSizePerProc));
+	benchmarks.push_back (new CMSB::ReduceScatterBlockBench (messageSizePerProc));
+	benchmarks.push_back (new CMSB::AlltoallwBench	  (messageSizePerProc));
 }
 
-void CMSB::createCollectiveMicroBenchesMinimalVer (std::vector<MicroBench*>& benchmarks, unsigned int messageSizePerProc) {
+void CMSB::createCollectiveMicroBenchesMinimalVer (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc) {
 	
 	benchmarks.push_back (new CMSB::BarrierBench   	  ());
 	benchmarks.push_back (new CMSB::BcastBench		  (messageSizePerProc));
@@ -219,7 +446,278 @@ void CMSB::createCollectiveMicroBenchesMinimalVer (std::vector<MicroBench*>& ben
 	//benchmarks.push_back (new CMSB::GatherAltBench	  (messageSizePerProc));
 }
 
-void CMSB::createCollectiveExtraSizeMicroBenches (std::vector<MicroBench*>& benchmarks, unsigned int messageSizePerProc) {
+void CMSB::createArrivalPatternMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc) {
+	
+	// Every rank but the late ones waits for one collective runtime
+	const CMSB::ArrivalPattern::Type patterns[] = {
+		CMSB::ArrivalPattern::NONE,
+		CMSB::ArrivalPattern::ONE_LATE,
+		CMSB::ArrivalPattern::LINEAR_SKEW,
+		CMSB::ArrivalPattern::RANDOM_UNIFORM,
+		CMSB::ArrivalPattern::RANDOM_EXPONENTIAL,
+		CMSB::ArrivalPattern::LATE_ROOT
+	};
+	const int num_patterns = sizeof (patterns) / sizeof (patterns[0]);
+	
+	for (int i = 0; i < num_patterns; i++) {
+		CMSB::ArrivalPattern pattern (patterns[i], 1.0);
+		CMSB::CollectivesBench* pattern_benches[] = {
+			new CMSB::BarrierBench	  (),
+			new CMSB::BcastBench	  (messageSizePerProc),
+			new CMSB::ReduceBench	  (messageSizePerProc),
+			new CMSB::AllreduceBench  (messageSizePerProc),
+			new CMSB::AlltoallBench	  (messageSizePerProc)
+		};
+		const int num_benches = sizeof (pattern_benches) / sizeof (pattern_benches[0]);
+		for (int j = 0; j < num_benches; j++) {
+			pattern_benches[j]->setArrivalPattern (pattern);
+			benchmarks.push_back (pattern_benches[j]);
+		}
+	}
+}
+
+// Creates the collectives of the variant benchmarks
+typedef CMSB::CollectivesBench* (*BenchFactory) (uint64_t messageSize);
+
+template <class Bench>
+static CMSB::CollectivesBench* newBench (uint64_t messageSize) {
+	
+	return new Bench (messageSize);
+}
+
+// Every bench of the list in every variant. Variant 0 stays as created
+// and is the baseline of the bench, configure (bench, variant) sets up
+// the other variants.
+template <class Configure>
+static void createVariantMicroBenches (std::vector<CMSB::MicroBench*>& benchmarks, uint64_t messageSizePerProc,
+									   const BenchFactory* benches, int numBenches, int numVariants,
+									   const Configure& configure) {
+	
+	std::vector<CMSB::CollectivesBench*> baselines (numBenches);
+	for (int v = 0; v < numVariants; v++) {
+		for (int j = 0; j < numBenches; j++) {
+			CMSB::CollectivesBench* bench = benches[j] (messageSizePerProc);
+			if (v == 0) baselines[j] = bench;
+			else {
+				configure (bench, v);
+				bench->setBaseline (baselines[j]);
+			}
+			benchmarks.push_back (bench);
+		}
+	}
+}
+
+struct DatatypeVariant {
+	DatatypeVariant (const CMSB::BenchDatatype::Kind* kinds) : _kinds (kinds) { }
+	void operator() (CMSB::CollectivesBench* bench, int variant) const {
+		bench->setDatatype (CMSB::BenchDatatype (_kinds[variant]));
+	}
+	const CMSB::BenchDatatype::Kind* _kinds;
+};
+
+struct OpVariant {
+	OpVariant (const CMSB::BenchOp::Kind* kinds) : _kinds (kinds) { }
+	void operator() (CMSB::CollectivesBench* bench, int variant) const {
+		CMSB::BenchOp op (_kinds[variant]);
+		bench->setDatatype (CMSB::BenchDatatype (op.getDatatypeKind ()));
+		bench->setOp (op);
+	}
+	const CMSB::BenchOp::Kind* _kinds;
+};
+
+struct InPlaceVariant {
+	void operator() (CMSB::CollectivesBench* bench, int) const {
+		bench->setInPlace (true);
+	}
+};
+
+struct CountDistributionVariant {
+	CountDistributionVariant (const CMSB::CountDistribution::Type* types) : _types (types) { }
+	void operator() (CMSB::CollectivesBench* bench, int variant) const {
+		bench->setCountDistribution (CMSB::CountDistribution (_types[variant]));
+	}
+	const CMSB::CountDistribution::Type* _types;
+};
+
+// A root below 0 stands for the policy itself
+struct RootVariant {
+	RootVariant (const std::vector<int>& roots, const CMSB::RootPolicy& policy) : _roots (roots), _policy (policy) { }
+	void operator() (CMSB::CollectivesBench* bench, int variant) const {
+		if (_roots[variant] < 0) bench->setRootPolicy (_policy);
+		else bench->setRootPolicy (CMSB::RootPolicy (CMSB::RootPolicy::FIXED, _roots[variant]));
+	}
+	const std::vector<int>& _roots;
+	const CMSB::RootPolicy& _policy;
+};
+
+void CMSB::createDatatypeMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc) {
+	
+	// Doubles first - they are the baseline of the other types. The
+	// derived types come last, the predefined reduction operations need
+	// basic ones.
+	const CMSB::BenchDatatype::Kind kinds[] = {
+		CMSB::BenchDatatype::DOUBLE,
+		CMSB::BenchDatatype::FLOAT,
+		CMSB::BenchDatatype::INT,
+		CMSB::BenchDatatype::LONG_LONG,
+		CMSB::BenchDatatype::DOUBLE_COMPLEX,
+		CMSB::BenchDatatype::VECTOR,
+		CMSB::BenchDatatype::INDEXED
+	};
+	const int num_kinds = sizeof (kinds) / sizeof (kinds[0]);
+	int num_basic_kinds = 0;
+	while (num_basic_kinds < num_kinds && !CMSB::BenchDatatype (kinds[num_basic_kinds]).isDerived ()) {
+		num_basic_kinds++;
+	}
+	const BenchFactory benches[] = {
+		newBench<CMSB::BcastBench>,
+		newBench<CMSB::GatherBench>,
+		newBench<CMSB::ScatterBench>,
+		newBench<CMSB::AllgatherBench>,
+		newBench<CMSB::AlltoallBench>,
+		newBench<CMSB::AlltoallvBench>
+	};
+	const BenchFactory reduction_benches[] = {
+		newBench<CMSB::ReduceBench>,
+		newBench<CMSB::AllreduceBench>
+	};
+	
+	createVariantMicroBenches (benchmarks, messageSizePerProc, benches, sizeof (benches) / sizeof (benches[0]),
+							   num_kinds, DatatypeVariant (kinds));
+	createVariantMicroBenches (benchmarks, messageSizePerProc, reduction_benches,
+							   sizeof (reduction_benches) / sizeof (reduction_benches[0]),
+							   num_basic_kinds, DatatypeVariant (kinds));
+}
+
+void CMSB::createReductionOpMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc) {
+	
+	// MPI_SUM first - it is the baseline of the other operations
+	const CMSB::BenchOp::Kind kinds[] = {
+		CMSB::BenchOp::SUM,
+		CMSB::BenchOp::MAX,
+		CMSB::BenchOp::MIN,
+		CMSB::BenchOp::PROD,
+		CMSB::BenchOp::BOR,
+		CMSB::BenchOp::MINLOC,
+		CMSB::BenchOp::MAXLOC,
+		CMSB::BenchOp::USER_SUM,
+		CMSB::BenchOp::USER_SUM_SIMD
+	};
+	const BenchFactory benches[] = {
+		newBench<CMSB::ReduceBench>,
+		newBench<CMSB::AllreduceBench>,
+		newBench<CMSB::ScanBench>,
+		newBench<CMSB::ReduceScatterBench>
+	};
+	
+	createVariantMicroBenches (benchmarks, messageSizePerProc, benches, sizeof (benches) / sizeof (benches[0]),
+							   sizeof (kinds) / sizeof (kinds[0]), OpVariant (kinds));
+}
+
+void CMSB::createLargeCountMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc) {
+	
+	// The collectives with a single count - their counts beyond int go to
+	// the large-count bindings or the contiguous fallback type. The
+	// buffers come from MAX_BUFF_SIZE_PER_PROC.
+	CMSB::CollectivesBench* reduce_local = new CMSB::ReduceLocalBench (messageSizePerProc);
+	CMSB::CollectivesBench* reduce = new CMSB::ReduceBench (messageSizePerProc);
+	CMSB::CollectivesBench* allreduce = new CMSB::AllreduceBench (messageSizePerProc);
+	reduce->setBaseline (reduce_local);
+	allreduce->setBaseline (reduce_local);
+	benchmarks.push_back (new CMSB::BcastBench				(messageSizePerProc));
+	benchmarks.push_back (reduce_local);
+	benchmarks.push_back (reduce);
+	benchmarks.push_back (allreduce);
+	benchmarks.push_back (new CMSB::GatherBench				(messageSizePerProc));
+	benchmarks.push_back (new CMSB::ScatterBench			(messageSizePerProc));
+	benchmarks.push_back (new CMSB::AllgatherBench			(messageSizePerProc));
+	benchmarks.push_back (new CMSB::AlltoallBench			(messageSizePerProc));
+	benchmarks.push_back (new CMSB::ScanBench				(messageSizePerProc));
+	benchmarks.push_back (new CMSB::ExscanBench				(messageSizePerProc));
+	benchmarks.push_back (new CMSB::ReduceScatterBlockBench	(messageSizePerProc));
+}
+
+void CMSB::createInPlaceMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc) {
+	
+	// Out-of-place first - it is the baseline of the in-place variant
+	const BenchFactory benches[] = {
+		newBench<CMSB::AllreduceBench>,
+		newBench<CMSB::AllgatherBench>,
+		newBench<CMSB::AlltoallBench>,
+		newBench<CMSB::ReduceBench>,
+		newBench<CMSB::GatherBench>,
+		newBench<CMSB::ScatterBench>,
+		newBench<CMSB::ScanBench>,
+		newBench<CMSB::ExscanBench>,
+		newBench<CMSB::ReduceScatterBench>,
+		newBench<CMSB::ReduceScatterBlockBench>,
+		newBench<CMSB::AllgathervBench>,
+		newBench<CMSB::AlltoallvBench>,
+		newBench<CMSB::AlltoallwBench>,
+		newBench<CMSB::GathervBench>,
+		newBench<CMSB::ScattervBench>
+	};
+	
+	createVariantMicroBenches (benchmarks, messageSizePerProc, benches, sizeof (benches) / sizeof (benches[0]),
+							   2, InPlaceVariant ());
+}
+
+void CMSB::createIrregularCountMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc) {
+	
+	// Regular counts first - they are the baseline of the other distributions
+	const CMSB::CountDistribution::Type types[] = {
+		CMSB::CountDistribution::REGULAR,
+		CMSB::CountDistribution::UNIFORM_RANDOM,
+		CMSB::CountDistribution::ZIPF,
+		CMSB::CountDistribution::SPARSE,
+		CMSB::CountDistribution::ONE_HEAVY
+	};
+	const BenchFactory benches[] = {
+		newBench<CMSB::AlltoallvBench>,
+		newBench<CMSB::AlltoallwBench>,
+		newBench<CMSB::AllgathervBench>,
+		newBench<CMSB::GathervBench>,
+		newBench<CMSB::ScattervBench>
+	};
+	
+	createVariantMicroBenches (benchmarks, messageSizePerProc, benches, sizeof (benches) / sizeof (benches[0]),
+							   sizeof (types) / sizeof (types[0]), CountDistributionVariant (types));
+}
+
+void CMSB::createRootPolicyMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc,
+                                         const CMSB::RootPolicy& policy) {
+	
+	int num_procs;
+	MPI_Comm_size (MPI_COMM_WORLD, &num_procs);
+	
+	// Root 0 first - it is the baseline of the other roots
+	std::vector<int> roots (1, 0);
+	if (policy.getType () == CMSB::RootPolicy::ROTATE) {
+		roots.push_back (-1);
+	}
+	else {
+		std::vector<int> policy_roots = policy.getRoots (num_procs);
+		for (size_t i = 0; i < policy_roots.size (); i++) {
+			if (policy_roots[i] != 0) roots.push_back (policy_roots[i]);
+		}
+	}
+	const BenchFactory benches[] = {
+		newBench<CMSB::BcastBench>,
+		newBench<CMSB::ReduceBench>,
+		newBench<CMSB::GatherBench>,
+		newBench<CMSB::ScatterBench>,
+		newBench<CMSB::GathervBench>,
+		newBench<CMSB::ScattervBench>,
+		newBench<CMSB::BcastAltBench>,
+		newBench<CMSB::GatherAltBench>,
+		newBench<CMSB::ReduceAltBench>
+	};
+	
+	createVariantMicroBenches (benchmarks, messageSizePerProc, benches, sizeof (benches) / sizeof (benches[0]),
+							   roots.size (), RootVariant (roots, policy));
+}
+
+void CMSB::createCollectiveExtraSizeMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc) {
 	
 	// Latency-oriented benchmarks
 	benchmarks.push_back (new CMSB::AllreduceBench	  (messageSizePerProc));
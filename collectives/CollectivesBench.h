@@ -3,7 +3,34 @@
 
 #include <mpi.h>
 #include <MicroBench.h>
+#include <stdint.h>
+#include <climits>
+#include <string>
 #include <vector>
+#include "ArrivalPattern.h"
+#include "BenchDatatype.h"
+#include "BenchOp.h"
+#include "CountDistribution.h"
+#include "RootPolicy.h"
+
+
+// Calls the large-count binding of MPI 4 for counts beyond int. Older
+// libraries never see such counts, BenchDatatype packs them into one
+// element of a contiguous type.
+#if MPI_VERSION >= 4
+#define LARGE_COUNT_CALL(name, args) \
+	do { if (_count > INT_MAX) MPI_##name##_c args; else MPI_##name args; } while (0)
+#else
+#define LARGE_COUNT_CALL(name, args) MPI_##name args
+#endif
+
+// Calls a v-collective on the VCount and VDispl arrays - always the
+// large-count binding with MPI 4
+#if MPI_VERSION >= 4
+#define V_COUNT_CALL(name, args) MPI_##name##_c args
+#else
+#define V_COUNT_CALL(name, args) MPI_##name args
+#endif
 
 
 namespace CMSB {
@@ -21,6 +48,9 @@ namespace CMSB {
         // Sufficient for quite accurate sample mean
         static const int NUM_ITERS_TOTAL = 400;	
 
+        // Iterations slower than this multiple of the median are outliers
+        static const double OUTLIER_FACTOR;
+
 
 		CollectivesBench  ();
 		virtual ~CollectivesBench ();
@@ -30,20 +60,112 @@ namespace CMSB {
 		virtual const char* getMicroBenchName  () const = 0;
 		virtual double getMicroBenchResult     () const { return _avgRunTime; }
 		virtual void writeResultToProfile      () const = 0;
-		virtual unsigned int getMemConsumption () const { return sizeof (CMSB::CollectivesBench); }
+		virtual unsigned int getMemConsumption () const {
+			return sizeof (CMSB::CollectivesBench)
+				   + (_sendBuff.capacity () + _recvBuff.capacity () + _localRunTimes.capacity ()) * sizeof (double)
+				   + _blockCounts.capacity () * sizeof (CMSB::VCount) + _blockDispls.capacity () * sizeof (CMSB::VDispl)
+				   + _rankNodes.capacity () * sizeof (int);
+		}
+		
+		void setArrivalPattern (const CMSB::ArrivalPattern& pattern) { _arrivalPattern = pattern; }
+		void setDatatype (const CMSB::BenchDatatype& type) { _benchType = type; }
+		void setOp (const CMSB::BenchOp& op) { _benchOp = op; }
+		void setCountDistribution (const CMSB::CountDistribution& dist) { _countDist = dist; }
+		void setInPlace (bool inPlace) { _inPlace = inPlace; }
+		// Only FIXED and ROTATE
+		void setRootPolicy (const CMSB::RootPolicy& policy) { _rootPolicy = policy; }
+		// The same collective in its default variant (doubles, MPI_SUM,
+		// root 0, ...), or Reduce_local for the reductions - not owned, it
+		// has to run before this one
+		void setBaseline (const CMSB::CollectivesBench* baseline) { _baseline = baseline; }
+		// Whether the collective takes the int counts and displacements of
+		// the v-collectives
+		virtual bool usesVCounts () const { return false; }
+		// Whether the collective only reduces locally - the reductions
+		// report their share in it as their baseline
+		virtual bool isLocalReduction () const { return false; }
+		
+		// Outliers of all collectives run so far, and how often each rank
+		// of MPI_COMM_WORLD was the last to complete them - rank 0 only
+		static int getNumOutliers () { return _numOutliers; }
+		static const std::vector<int>& getStragglerCounts () { return _stragglerCounts; }
 		
 	protected:
 		virtual void performMPICollectiveFunc () = 0;
+		// Called after every round that counts with the numbers (see
+		// _roundIter) of its valid iterations, in the order of the results
+		virtual void keepIterations (const int*, int) { }
+		// Prefix of the result lines - the name plus the measured variant
+		virtual std::string getResultLabel () const;
+		// Reports on rank 0 that the benchmark is skipped if its counts
+		// overflow
+		bool skipOnCountOverflow ();
+		// Switches to own buffers if the shared ones are shorter than the
+		// given lengths in bytes
+		void reserveBuffers (uint64_t sendLen, uint64_t recvLen);
+		// Median per root and per node of the root with a rotating root
+		void printRootBreakdown (const std::string& label, const double* runTimes, const int* roots) const;
+		// MPI_IN_PLACE in the in-place variant - on all ranks, or only at
+		// the root for the send buffer of Reduce and Gather(v) and the
+		// receive buffer of Scatter(v)
+		void* getSendBuff () const { return _inPlace ? MPI_IN_PLACE : _benchInfo._sendBuff; }
+		void* getRootSendBuff () const { return (_inPlace && _myRank == _root) ? MPI_IN_PLACE : _benchInfo._sendBuff; }
+		void* getRootRecvBuff () const { return (_inPlace && _myRank == _root) ? MPI_IN_PLACE : _benchInfo._recvBuff; }
     
 		int 			_myRank;
 		int 			_numProcs;
 		double 			_avgRunTime;
-		unsigned int	_msgSize;	// In number of doubles to send
+		uint64_t		_msgSize;	// In number of doubles to send
+		MPI_Count		_count;		// _msgSize doubles in elements of _datatype
+		MPI_Datatype	_datatype;
+		CMSB::BenchDatatype _benchType;
+		MPI_Op			_op;		// Of the reductions
+		CMSB::BenchOp	_benchOp;
+		const CMSB::CollectivesBench* _baseline;
+		bool			_inPlace;
+		// Peak heap allocated by the warmup calls over all ranks - rank 0 only
+		uint64_t		_peakMem;
+		// The message does not fit the int counts or displacements the
+		// collective takes before MPI 4 - set by init on all ranks, the
+		// run is skipped
+		bool			_countOverflow;
+		CMSB::ArrivalPattern _arrivalPattern;
+		// Counts of the v-collectives - the Alltoallv pattern goes to the
+		// counts of _benchInfo, the blocks of the ranks in the rooted and
+		// all-gather ones (and Reduce_scatter) are kept here
+		CMSB::CountDistribution _countDist;
+		std::vector<CMSB::VCount>	_blockCounts;
+		std::vector<CMSB::VDispl>	_blockDispls;
+		// Root of the current iteration of the rooted collectives
+		CMSB::RootPolicy	_rootPolicy;
+		int					_root;
+		// Iteration of the current round while it runs, -1 in the warmups
+		int					_roundIter;
+		// Node (named after the rank of its leader) of every rank - rank 0
+		// only and only if the root moves away from rank 0
+		std::vector<int>	_rankNodes;
+		// Valid run times of this rank in the order of the results - the
+		// results are their maxima over all ranks
+		std::vector<double>	_localRunTimes;
+		// Own buffers if the message doesn't fit the shared ones
+		std::vector<double>	_sendBuff;
+		std::vector<double>	_recvBuff;
+		
+		static int				_numOutliers;
+		static std::vector<int>	_stragglerCounts;
 	};
 	
-	void createCollectiveMicroBenches (std::vector<MicroBench*>& benchmarks, unsigned int messageSizePerProc);
-	void createCollectiveMicroBenchesMinimalVer (std::vector<MicroBench*>& benchmarks, unsigned int messageSizePerProc);
-    void createCollectiveExtraSizeMicroBenches (std::vector<MicroBench*>& benchmarks, unsigned int messageSizePerProc);
+	void createCollectiveMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc);
+	void createCollectiveMicroBenchesMinimalVer (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc);
+    void createCollectiveExtraSizeMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc);
+    void createArrivalPatternMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc);
+    void createDatatypeMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc);
+    void createReductionOpMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc);
+    void createLargeCountMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc);
+    void createInPlaceMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc);
+    void createIrregularCountMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc);
+    void createRootPolicyMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc,
+                                       const CMSB::RootPolicy& policy);
 }
 
 
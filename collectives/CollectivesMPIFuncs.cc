@@ -4,10 +4,13 @@
 #include "AllreduceBench.h"
 #include "GatherBench.h"
 #include "ReduceBench.h"
+#include "ReduceLocalBench.h"
 #include "BcastBench.h"
+#include "ExscanBench.h"
 #include "ScatterBench.h"
 #include "ScanBench.h"
 #include "ReduceScatterBench.h"
+#include "ReduceScatterBlockBench.h"
 #include "AlltoallvBench.h"
 #include "AllgathervBench.h"
 #include "GathervBench.h"
@@ -20,7 +23,7 @@
 
 void CMSB::AlltoallBench::performMPICollectiveFunc () {
 
-    MPI_Alltoall (_benchInfo._sendBuff, _msgSize, MPI_DOUBLE, _benchInfo._recvBuff, _msgSize, MPI_DOUBLE, _worldComm);
+    LARGE_COUNT_CALL (Alltoall, (getSendBuff (), _count, _datatype, _benchInfo._recvBuff, _count, _datatype, _worldComm));
 }
 
 
@@ -29,7 +32,7 @@ void CMSB::AlltoallBench::performMPICollectiveFunc () {
 
 void CMSB::AllgatherBench::performMPICollectiveFunc () {
 
-    MPI_Allgather (_benchInfo._sendBuff, _msgSize, MPI_DOUBLE, _benchInfo._recvBuff, _msgSize, MPI_DOUBLE, _worldComm);
+    LARGE_COUNT_CALL (Allgather, (getSendBuff (), _count, _datatype, _benchInfo._recvBuff, _count, _datatype, _worldComm));
 }
 
 
@@ -38,7 +41,7 @@ void CMSB::AllgatherBench::performMPICollectiveFunc () {
 
 void CMSB::AllreduceBench::performMPICollectiveFunc () {
 
-    MPI_Allreduce (_benchInfo._sendBuff, _benchInfo._recvBuff, _msgSize, MPI_DOUBLE, MPI_SUM, _worldComm);
+    LARGE_COUNT_CALL (Allreduce, (getSendBuff (), _benchInfo._recvBuff, _count, _datatype, _op, _worldComm));
 }
 
 
@@ -47,7 +50,7 @@ void CMSB::AllreduceBench::performMPICollectiveFunc () {
 
 void CMSB::GatherBench::performMPICollectiveFunc () {
 
-    MPI_Gather (_benchInfo._sendBuff, _msgSize, MPI_DOUBLE, _benchInfo._recvBuff, _msgSize, MPI_DOUBLE, 0, _worldComm);
+    LARGE_COUNT_CALL (Gather, (getRootSendBuff (), _count, _datatype, _benchInfo._recvBuff, _count, _datatype, _root, _worldComm));
 }
 
 
@@ -56,7 +59,18 @@ void CMSB::GatherBench::performMPICollectiveFunc () {
 
 void CMSB::ReduceBench::performMPICollectiveFunc () {
 
-    MPI_Reduce (_benchInfo._sendBuff, _benchInfo._recvBuff, _msgSize, MPI_DOUBLE, MPI_SUM, 0, _worldComm);
+    LARGE_COUNT_CALL (Reduce, (getRootSendBuff (), _benchInfo._recvBuff, _count, _datatype, _op, _root, _worldComm));
+}
+
+
+//======================================================================
+
+
+void CMSB::ReduceLocalBench::performMPICollectiveFunc () {
+
+    // No communication - the time one rank spends combining two buffers,
+    // the computational part of a step of Reduce and Allreduce
+    LARGE_COUNT_CALL (Reduce_local, (_benchInfo._sendBuff, _benchInfo._recvBuff, _count, _datatype, _op));
 }
 
 
@@ -65,7 +79,16 @@ void CMSB::ReduceBench::performMPICollectiveFunc () {
 
 void CMSB::BcastBench::performMPICollectiveFunc () {
 
-    MPI_Bcast (_benchInfo._sendBuff, _msgSize, MPI_DOUBLE, 0, _worldComm);
+    LARGE_COUNT_CALL (Bcast, (_benchInfo._sendBuff, _count, _datatype, _root, _worldComm));
+}
+
+
+//======================================================================
+
+
+void CMSB::ExscanBench::performMPICollectiveFunc () {
+
+    LARGE_COUNT_CALL (Exscan, (getSendBuff (), _benchInfo._recvBuff, _count, _datatype, _op, _worldComm));
 }
 
 
@@ -74,7 +97,7 @@ void CMSB::BcastBench::performMPICollectiveFunc () {
 
 void CMSB::ScatterBench::performMPICollectiveFunc () {
 
-    MPI_Scatter (_benchInfo._sendBuff, _msgSize, MPI_DOUBLE, _benchInfo._recvBuff, _msgSize, MPI_DOUBLE, 0, _worldComm);
+    LARGE_COUNT_CALL (Scatter, (_benchInfo._sendBuff, _count, _datatype, getRootRecvBuff (), _count, _datatype, _root, _worldComm));
 }
 
 
@@ -83,7 +106,7 @@ void CMSB::ScatterBench::performMPICollectiveFunc () {
 
 void CMSB::ScanBench::performMPICollectiveFunc () {
 
-    MPI_Scan (_benchInfo._sendBuff, _benchInfo._recvBuff, _msgSize, MPI_DOUBLE, MPI_SUM, _worldComm);
+    LARGE_COUNT_CALL (Scan, (getSendBuff (), _benchInfo._recvBuff, _count, _datatype, _op, _worldComm));
 }
 
 
@@ -92,7 +115,16 @@ void CMSB::ScanBench::performMPICollectiveFunc () {
 
 void CMSB::ReduceScatterBench::performMPICollectiveFunc () {
 
-    MPI_Reduce_scatter (_benchInfo._sendBuff, _benchInfo._recvBuff, _benchInfo._recvCounts, MPI_DOUBLE, MPI_SUM, _worldComm);
+    V_COUNT_CALL (Reduce_scatter, (getSendBuff (), _benchInfo._recvBuff, &_blockCounts[0], _datatype, _op, _worldComm));
+}
+
+
+//======================================================================
+
+
+void CMSB::ReduceScatterBlockBench::performMPICollectiveFunc () {
+
+    LARGE_COUNT_CALL (Reduce_scatter_block, (getSendBuff (), _benchInfo._recvBuff, _count, _datatype, _op, _worldComm));
 }
 
 
@@ -101,9 +133,9 @@ void CMSB::ReduceScatterBench::performMPICollectiveFunc () {
 
 void CMSB::AlltoallvBench::performMPICollectiveFunc () {
 
-    MPI_Alltoallv (_benchInfo._sendBuff, _benchInfo._sendCounts, _benchInfo._sendDispls, MPI_DOUBLE,
-                   _benchInfo._recvBuff, _benchInfo._recvCounts, _benchInfo._recvDispls, MPI_DOUBLE,
-                   _worldComm);
+    V_COUNT_CALL (Alltoallv, (getSendBuff (), _benchInfo._sendCounts, _benchInfo._sendDispls, _datatype,
+                              _benchInfo._recvBuff, _benchInfo._recvCounts, _benchInfo._recvDispls, _datatype,
+                              _worldComm));
 }
 
 
@@ -112,8 +144,8 @@ void CMSB::AlltoallvBench::performMPICollectiveFunc () {
 
 void CMSB::AllgathervBench::performMPICollectiveFunc () {
 
-    MPI_Allgatherv (_benchInfo._sendBuff, _msgSize, MPI_DOUBLE, _benchInfo._recvBuff, _benchInfo._recvCounts,
-                    _benchInfo._recvDispls, MPI_DOUBLE, _worldComm);
+    V_COUNT_CALL (Allgatherv, (getSendBuff (), _blockCounts[_myRank], _datatype, _benchInfo._recvBuff, &_blockCounts[0],
+                               &_blockDispls[0], _datatype, _worldComm));
 }
 
 
@@ -122,8 +154,8 @@ void CMSB::AllgathervBench::performMPICollectiveFunc () {
 
 void CMSB::GathervBench::performMPICollectiveFunc () {
 
-    MPI_Gatherv (_benchInfo._sendBuff, _msgSize, MPI_DOUBLE, _benchInfo._recvBuff, _benchInfo._recvCounts,
-                 _benchInfo._recvDispls, MPI_DOUBLE, 0, _worldComm);
+    V_COUNT_CALL (Gatherv, (getRootSendBuff (), _blockCounts[_myRank], _datatype, _benchInfo._recvBuff, &_blockCounts[0],
+                            &_blockDispls[0], _datatype, _root, _worldComm));
 }
 
 
@@ -132,8 +164,8 @@ void CMSB::GathervBench::performMPICollectiveFunc () {
 
 void CMSB::ScattervBench::performMPICollectiveFunc () {
 
-    MPI_Scatterv (_benchInfo._sendBuff, _benchInfo._sendCounts, _benchInfo._sendDispls, MPI_DOUBLE,
-                  _benchInfo._recvBuff, _msgSize, MPI_DOUBLE, 0, _worldComm);
+    V_COUNT_CALL (Scatterv, (_benchInfo._sendBuff, &_blockCounts[0], &_blockDispls[0], _datatype,
+                             getRootRecvBuff (), _blockCounts[_myRank], _datatype, _root, _worldComm));
 }
 
 
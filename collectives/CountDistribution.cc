@@ -0,0 +1,67 @@
+#include "CountDistribution.h"
+
+
+
+CMSB::CountDistribution::CountDistribution (Type type, unsigned int seed) :
+	_type			(type),
+	_seed			(seed),
+	_numProcs		(1),
+	_meanCount		(0),
+	_harmonicSum	(1.0) {
+
+}
+
+void CMSB::CountDistribution::init (int numProcs, int64_t meanCount) {
+
+	_numProcs = numProcs;
+	_meanCount = meanCount;
+	_harmonicSum = 0.0;
+	for (int k = 1; k <= numProcs; k++) _harmonicSum += 1.0 / k;
+}
+
+int64_t CMSB::CountDistribution::getCount (int src, int dst) const {
+
+	switch (_type) {
+		case UNIFORM_RANDOM:
+			return int64_t (2.0 * _meanCount * random (src, dst) + 0.5);
+		case ZIPF: {
+			// The size class is uniform, the class k has the count
+			// c/k - c is chosen to keep the mean
+			int k = 1 + int (_numProcs * random (src, dst));
+			return int64_t (_meanCount * _numProcs / (_harmonicSum * k) + 0.5);
+		}
+		case SPARSE:
+			return (random (src, dst) * SPARSE_INV_DENSITY < 1.0) ? _meanCount * SPARSE_INV_DENSITY : 0;
+		case ONE_HEAVY:
+			return (src == _numProcs-1 || dst == _numProcs-1) ? _meanCount * HEAVY_FACTOR : _meanCount;
+		default:
+			return _meanCount;
+	}
+}
+
+const char* CMSB::CountDistribution::getName () const {
+
+	switch (_type) {
+		case UNIFORM_RANDOM:	return "uniform_random";
+		case ZIPF:				return "zipf";
+		case SPARSE:			return "sparse";
+		case ONE_HEAVY:			return "one_heavy";
+		default:				return "regular";
+	}
+}
+
+double CMSB::CountDistribution::random (int src, int dst) const {
+
+	// Integer hash of the seed and the pair (the finalizer of MurmurHash3)
+	unsigned int h = _seed;
+	unsigned int keys[2] = { (unsigned int)src, (unsigned int)dst };
+	for (int i = 0; i < 2; i++) {
+		h ^= keys[i] * 0x9E3779B1U;
+		h ^= h >> 16;
+		h *= 0x85EBCA6BU;
+		h ^= h >> 13;
+		h *= 0xC2B2AE35U;
+		h ^= h >> 16;
+	}
+	return h / 4294967296.0;
+}
@@ -0,0 +1,57 @@
+#ifndef __COUNT_DISTRIBUTION_H__
+#define __COUNT_DISTRIBUTION_H__
+
+#include <stdint.h>
+
+
+namespace CMSB {
+
+	/**
+	 * Element counts of the v-collectives. The count a rank sends to
+	 * another one is drawn from a hash of the pair and a fixed seed, so
+	 * every rank knows the whole count matrix without communication and
+	 * the send counts of one rank match the receive counts of its peers.
+	 * All distributions keep the mean count at the regular one.
+	 */
+	class CountDistribution {
+
+	public:
+
+		enum Type {
+			REGULAR,			// Every count is the mean
+			UNIFORM_RANDOM,		// Uniform random in [0, 2*mean]
+			ZIPF,				// Falls off as 1/k over P size classes k
+			SPARSE,				// Most counts are zero, the rest are large
+			ONE_HEAVY			// The last rank sends and receives much more
+		};
+
+		// One in SPARSE_INV_DENSITY counts is non-zero
+		static const int SPARSE_INV_DENSITY = 8;
+		// The counts of the heavy rank in multiples of the mean
+		static const int HEAVY_FACTOR = 8;
+
+		CountDistribution (Type type = REGULAR, unsigned int seed = 1);
+
+		void init (int numProcs, int64_t meanCount);
+		// Count from rank src to rank dst in the Alltoallv pattern
+		int64_t getCount (int src, int dst) const;
+		// Block of a rank in the rooted and all-gather v-collectives
+		int64_t getBlockCount (int rank) const { return getCount (rank, rank); }
+		Type getType () const { return _type; }
+		const char* getName () const;
+
+	protected:
+		// Uniform in [0, 1) for the pair
+		double random (int src, int dst) const;
+
+		Type			_type;
+		unsigned int	_seed;
+		int				_numProcs;
+		int64_t			_meanCount;
+		double			_harmonicSum;	// Of 1/k over the P size classes of ZIPF
+	};
+
+}
+
+
+#endif   // __COUNT_DISTRIBUTION_H__
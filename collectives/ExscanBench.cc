@@ -0,0 +1,49 @@
+#include <mpi.h>
+#include "ExscanBench.h"
+
+#ifdef USE_SCOREP
+#include <scorep/SCOREP_User.h>
+#endif
+
+
+
+
+//======================================================================
+
+#ifdef USE_SCOREP
+SCOREP_USER_METRIC_LOCAL (bench_ExscanBench_metric);
+#endif
+
+
+CMSB::ExscanBench::ExscanBench (uint64_t messageSize) {
+
+    _msgSize = messageSize;
+}
+
+CMSB::ExscanBench::~ExscanBench () {
+}
+
+void CMSB::ExscanBench::init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo) {
+
+	CMSB::CollectivesBench::init (worldComm, benchInfo);
+#ifdef USE_SCOREP
+    SCOREP_USER_METRIC_INIT (bench_ExscanBench_metric, "Exscan timing", "usec",
+                             SCOREP_USER_METRIC_TYPE_DOUBLE, SCOREP_USER_METRIC_CONTEXT_GLOBAL);
+#endif
+}
+
+const char* CMSB::ExscanBench::getMicroBenchName () const {
+
+    return "MPI_Exscan";
+}
+
+void CMSB::ExscanBench::writeResultToProfile () const {
+
+#ifdef USE_SCOREP
+	if (_myRank == 0) {		// Only one rank should update SCORE-P's metrics
+		SCOREP_USER_METRIC_DOUBLE (bench_ExscanBench_metric, getMicroBenchResult ());
+	}
+#endif
+}
+
+//======================================================================
@@ -0,0 +1,31 @@
+#ifndef __Exscan_BENCH_H__
+#define __Exscan_BENCH_H__
+
+
+#include "CollectivesBench.h"
+
+
+namespace CMSB {
+
+	/**
+	 * Represents Exscan benchmark.
+	 */
+	class ExscanBench : public CMSB::CollectivesBench {
+
+	public:
+
+		ExscanBench  (uint64_t messageSize);
+		virtual ~ExscanBench ();
+		
+		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
+        virtual const char* getMicroBenchName () const;
+		virtual void writeResultToProfile () const;
+
+	protected:
+		virtual void performMPICollectiveFunc ();
+	};
+	
+}
+
+
+#endif   // __Exscan_BENCH_H__
@@ -17,7 +17,7 @@ SCOREP_USER_METRIC_LOCAL (bench_GatherAltBench_metric);
 #endif
 
 
-CMSB::GatherAltBench::GatherAltBench (unsigned int messageSize) {
+CMSB::GatherAltBench::GatherAltBench (uint64_t messageSize) {
 
     _msgSize = messageSize;
 }
@@ -28,6 +28,8 @@ CMSB::GatherAltBench::~GatherAltBench () {
 void CMSB::GatherAltBench::init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo) {
 
 	CMSB::CollectivesBench::init (worldComm, benchInfo);
+	// The messages of the tree hold up to all blocks in plain doubles
+	_countOverflow = (_msgSize * _numProcs > INT_MAX);
 #ifdef USE_SCOREP
     SCOREP_USER_METRIC_INIT (bench_GatherAltBench_metric, "GatherAlt timing", "usec",
                              SCOREP_USER_METRIC_TYPE_DOUBLE, SCOREP_USER_METRIC_CONTEXT_GLOBAL);
@@ -51,7 +53,7 @@ void CMSB::GatherAltBench::writeResultToProfile () const {
 void CMSB::GatherAltBench::performMPICollectiveFunc () {
 	
 	// Alternative implementation of MPI_Bcast.
-	// MPI_Gather (_benchInfo._sendBuff, _msgSize, MPI_DOUBLE, _benchInfo._recvBuff, _msgSize, MPI_DOUBLE, 0, _worldComm);
+	// MPI_Gather (_benchInfo._sendBuff, _msgSize, MPI_DOUBLE, _benchInfo._recvBuff, _msgSize, MPI_DOUBLE, _root, _worldComm);
 	// The idea is to use MST implementation to get a clear expectation how much time
 	// the bcast operation will take. The expected model is: T = log(P)*alpha+(p-1)/p*Nbeta,
 	// where p - number of processes, N - message size in bytes, alpha - latency, and beta -
@@ -65,7 +67,7 @@ void CMSB::GatherAltBench::performMPICollectiveFunc () {
 	//	}
 	//	std::cout << std::endl;
 	//}
-	gatherAltImpl (0, 0, _numProcs-1);
+	gatherAltImpl (_root, 0, _numProcs-1);
 	
 	// Check for correctness of the operation - every rank should have the root's buffer, which
 	// contains ones
@@ -98,7 +100,7 @@ void CMSB::GatherAltBench::gatherAltImpl (int root, int left, int right) {
 		gatherAltImpl (root, mid+1, right);
 		
 	if (root <= mid) {
-		int data_length = right - (mid+1) + 1;
+		int data_length = (right - (mid+1) + 1) * _msgSize;
 		if (_myRank == src)
 			MPI_Send (_benchInfo._recvBuff + _msgSize*(mid+1), data_length, MPI_DOUBLE, root, 0, _worldComm);
 		if (_myRank == root) {
@@ -107,7 +109,7 @@ void CMSB::GatherAltBench::gatherAltImpl (int root, int left, int right) {
 		}
 	}
 	else {
-		int data_length = mid - left + 1;
+		int data_length = (mid - left + 1) * _msgSize;
 		if (_myRank == src)
 			MPI_Send (_benchInfo._recvBuff + _msgSize*left, data_length, MPI_DOUBLE, root, 0, _worldComm);
 		if (_myRank == root) {
@@ -14,7 +14,7 @@ namespace CMSB {
 
 	public:
 
-		GatherAltBench  (unsigned int messageSize);
+		GatherAltBench  (uint64_t messageSize);
 		virtual ~GatherAltBench ();
 		
 		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
@@ -15,7 +15,7 @@ SCOREP_USER_METRIC_LOCAL (bench_GatherBench_metric);
 #endif
 
 
-CMSB::GatherBench::GatherBench (unsigned int messageSize) {
+CMSB::GatherBench::GatherBench (uint64_t messageSize) {
 
     _msgSize = messageSize;
 }
@@ -14,7 +14,7 @@ namespace CMSB {
 
 	public:
 
-		GatherBench  (unsigned int messageSize);
+		GatherBench  (uint64_t messageSize);
 		virtual ~GatherBench ();
 		
 		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
@@ -15,7 +15,7 @@ SCOREP_USER_METRIC_LOCAL (bench_GathervBench_metric);
 #endif
 
 
-CMSB::GathervBench::GathervBench (unsigned int messageSize) {
+CMSB::GathervBench::GathervBench (uint64_t messageSize) {
 
     _msgSize = messageSize;
 }
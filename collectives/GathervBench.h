@@ -14,12 +14,13 @@ namespace CMSB {
 
 	public:
 
-		GathervBench  (unsigned int messageSize);
+		GathervBench  (uint64_t messageSize);
 		virtual ~GathervBench ();
 		
 		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
         virtual const char* getMicroBenchName () const;
 		virtual void writeResultToProfile () const;
+		virtual bool usesVCounts () const { return true; }
 
 	protected:
 		virtual void performMPICollectiveFunc ();
@@ -0,0 +1,77 @@
+#ifndef __INTER_BENCHES_H__
+#define __INTER_BENCHES_H__
+
+
+#include <mpi.h>
+#include "InterCollectivesBench.h"
+
+
+namespace CMSB {
+
+	/**
+	 * The collectives defined on intercommunicators. Each group receives
+	 * the data of the other one, so Allgather and Alltoall exchange
+	 * blocks with the ranks of the remote group only.
+	 */
+
+	class InterBcastBench : public CMSB::InterCollectivesBench {
+	public:
+		InterBcastBench (uint64_t messageSize, const CMSB::CollectivesBench* baseline)
+			: InterCollectivesBench (messageSize, baseline) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Bcast"; }
+	protected:
+		virtual void performMPICollectiveFunc () {
+			LARGE_COUNT_CALL (Bcast, (_benchInfo._sendBuff, _count, _datatype, _bcastRoot, _interComm));
+		}
+	};
+
+	class InterAllreduceBench : public CMSB::InterCollectivesBench {
+	public:
+		InterAllreduceBench (uint64_t messageSize, const CMSB::CollectivesBench* baseline)
+			: InterCollectivesBench (messageSize, baseline) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Allreduce"; }
+	protected:
+		virtual void performMPICollectiveFunc () {
+			LARGE_COUNT_CALL (Allreduce, (_benchInfo._sendBuff, _benchInfo._recvBuff, _count, _datatype, _op, _interComm));
+		}
+	};
+
+	class InterAllgatherBench : public CMSB::InterCollectivesBench {
+	public:
+		InterAllgatherBench (uint64_t messageSize, const CMSB::CollectivesBench* baseline)
+			: InterCollectivesBench (messageSize, baseline) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Allgather"; }
+	protected:
+		virtual void performMPICollectiveFunc () {
+			LARGE_COUNT_CALL (Allgather, (_benchInfo._sendBuff, _count, _datatype,
+										  _benchInfo._recvBuff, _count, _datatype, _interComm));
+		}
+	};
+
+	class InterAlltoallBench : public CMSB::InterCollectivesBench {
+	public:
+		InterAlltoallBench (uint64_t messageSize, const CMSB::CollectivesBench* baseline)
+			: InterCollectivesBench (messageSize, baseline) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Alltoall"; }
+	protected:
+		virtual void performMPICollectiveFunc () {
+			LARGE_COUNT_CALL (Alltoall, (_benchInfo._sendBuff, _count, _datatype,
+										 _benchInfo._recvBuff, _count, _datatype, _interComm));
+		}
+	};
+
+	class InterBarrierBench : public CMSB::InterCollectivesBench {
+	public:
+		InterBarrierBench (const CMSB::CollectivesBench* baseline)
+			: InterCollectivesBench (0, baseline) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Barrier"; }
+	protected:
+		virtual void performMPICollectiveFunc () {
+			MPI_Barrier (_interComm);
+		}
+	};
+
+}
+
+
+#endif   // __INTER_BENCHES_H__
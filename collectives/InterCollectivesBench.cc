@@ -0,0 +1,84 @@
+#include <mpi.h>
+#include "InterCollectivesBench.h"
+#include "InterBenches.h"
+#include "AllgatherBench.h"
+#include "AllreduceBench.h"
+#include "AlltoallBench.h"
+#include "BarrierBench.h"
+#include "BcastBench.h"
+
+
+
+CMSB::InterCollectivesBench::InterCollectivesBench (uint64_t messageSize, const CMSB::CollectivesBench* baseline) :
+	_interComm		(MPI_COMM_NULL),
+	_inLowerGroup	(true),
+	_bcastRoot		(MPI_ROOT) {
+
+	_msgSize = messageSize;
+	_baseline = baseline;
+}
+
+CMSB::InterCollectivesBench::~InterCollectivesBench () {
+
+	freeInterComm ();
+}
+
+void CMSB::InterCollectivesBench::init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo) {
+
+	CMSB::CollectivesBench::init (worldComm, benchInfo);
+	freeInterComm ();
+
+	// The leaders are the first ranks of both halves
+	int lower_size = _numProcs / 2;
+	MPI_Comm local_comm;
+	_inLowerGroup = (_myRank < lower_size);
+	MPI_Comm_split (_worldComm, _inLowerGroup ? 0 : 1, _myRank, &local_comm);
+	MPI_Intercomm_create (local_comm, 0, _worldComm, _inLowerGroup ? lower_size : 0, 0, &_interComm);
+	MPI_Comm_free (&local_comm);
+
+	// The upper group names the root by its rank in the lower group
+	if (_inLowerGroup) {
+		_bcastRoot = (_myRank == 0) ? MPI_ROOT : MPI_PROC_NULL;
+	}
+	else {
+		_bcastRoot = 0;
+	}
+}
+
+std::string CMSB::InterCollectivesBench::getResultLabel () const {
+
+	return CMSB::CollectivesBench::getResultLabel () + "[intercomm]";
+}
+
+void CMSB::InterCollectivesBench::freeInterComm () {
+
+	if (_interComm != MPI_COMM_NULL) {
+		MPI_Comm_free (&_interComm);
+	}
+}
+
+void CMSB::createInterCollectiveMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc) {
+
+	// The intracommunicator case of each collective is the baseline, so
+	// it runs first
+	CMSB::CollectivesBench* bcast = new CMSB::BcastBench (messageSizePerProc);
+	CMSB::CollectivesBench* allreduce = new CMSB::AllreduceBench (messageSizePerProc);
+	CMSB::CollectivesBench* allgather = new CMSB::AllgatherBench (messageSizePerProc);
+	CMSB::CollectivesBench* alltoall = new CMSB::AlltoallBench (messageSizePerProc);
+	CMSB::CollectivesBench* barrier = new CMSB::BarrierBench ();
+	benchmarks.push_back (bcast);
+	benchmarks.push_back (allreduce);
+	benchmarks.push_back (allgather);
+	benchmarks.push_back (alltoall);
+	benchmarks.push_back (barrier);
+
+	// An intercommunicator needs two non-empty groups
+	int num_procs;
+	MPI_Comm_size (MPI_COMM_WORLD, &num_procs);
+	if (num_procs < 2) return;
+	benchmarks.push_back (new CMSB::InterBcastBench		(messageSizePerProc, bcast));
+	benchmarks.push_back (new CMSB::InterAllreduceBench	(messageSizePerProc, allreduce));
+	benchmarks.push_back (new CMSB::InterAllgatherBench	(messageSizePerProc, allgather));
+	benchmarks.push_back (new CMSB::InterAlltoallBench	(messageSizePerProc, alltoall));
+	benchmarks.push_back (new CMSB::InterBarrierBench	(barrier));
+}
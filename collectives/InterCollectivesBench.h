@@ -0,0 +1,46 @@
+#ifndef __INTER_COLLECTIVES_BENCH_H__
+#define __INTER_COLLECTIVES_BENCH_H__
+
+
+#include <mpi.h>
+#include <string>
+#include <vector>
+#include "CollectivesBench.h"
+
+
+namespace CMSB {
+
+	/**
+	 * Base class for the collectives on an intercommunicator. worldComm
+	 * is split into a lower and an upper half, which are joined again by
+	 * MPI_Intercomm_create - like the two solver groups of a coupled run.
+	 * The harness keeps using worldComm, only the measured collective
+	 * runs on the intercommunicator. The baseline is the same collective
+	 * on worldComm, an intracommunicator of the same total size.
+	 */
+	class InterCollectivesBench : public CMSB::CollectivesBench {
+
+	public:
+
+		// The baseline is not owned, it has to run before this benchmark
+		InterCollectivesBench  (uint64_t messageSize, const CMSB::CollectivesBench* baseline = NULL);
+		virtual ~InterCollectivesBench ();
+
+		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
+		virtual void writeResultToProfile () const { }
+		virtual unsigned int getMemConsumption () const { return sizeof (CMSB::InterCollectivesBench); }
+
+	protected:
+		virtual std::string getResultLabel () const;
+		void freeInterComm ();
+
+		MPI_Comm		_interComm;
+		bool			_inLowerGroup;
+		int				_bcastRoot;		// World rank 0 is the root of Bcast
+	};
+
+	void createInterCollectiveMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc);
+}
+
+
+#endif   // __INTER_COLLECTIVES_BENCH_H__
@@ -0,0 +1,102 @@
+#ifndef __NEIGHBOR_BENCHES_H__
+#define __NEIGHBOR_BENCHES_H__
+
+
+#include <mpi.h>
+#include "NeighborCollectivesBench.h"
+
+
+namespace CMSB {
+
+	/**
+	 * What the stencil codes do by hand: one Isend and one Irecv per
+	 * neighbor, the message to direction k arrives from direction k^1.
+	 */
+	class HaloExchangeBench : public CMSB::NeighborCollectivesBench {
+	public:
+		HaloExchangeBench (uint64_t messageSize) : NeighborCollectivesBench (messageSize, CARTESIAN) {}
+		virtual const char* getMicroBenchName () const { return "Isend_Irecv_halo"; }
+	protected:
+		virtual void performMPICollectiveFunc () {
+			MPI_Request requests[2*MAX_NEIGHBORS];
+			for (int k = 0; k < _numNeighbors; k++) {
+				LARGE_COUNT_CALL (Irecv, ((char*)_benchInfo._recvBuff + _byteDispls[k], _count, _datatype,
+										  _neighbors[k], k^1, _topoComm, &requests[2*k]));
+				LARGE_COUNT_CALL (Isend, ((char*)_benchInfo._sendBuff + _byteDispls[k], _count, _datatype,
+										  _neighbors[k], k, _topoComm, &requests[2*k+1]));
+			}
+			MPI_Waitall (2*_numNeighbors, requests, MPI_STATUSES_IGNORE);
+		}
+	};
+
+#if MPI_VERSION >= 3
+
+	class NeighborAllgatherBench : public CMSB::NeighborCollectivesBench {
+	public:
+		NeighborAllgatherBench (uint64_t messageSize, Topology topology, const CMSB::CollectivesBench* reference)
+			: NeighborCollectivesBench (messageSize, topology, reference) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Neighbor_allgather"; }
+	protected:
+		virtual void performMPICollectiveFunc () {
+			LARGE_COUNT_CALL (Neighbor_allgather, (_benchInfo._sendBuff, _count, _datatype,
+												   _benchInfo._recvBuff, _count, _datatype, _topoComm));
+		}
+	};
+
+	class NeighborAllgathervBench : public CMSB::NeighborCollectivesBench {
+	public:
+		NeighborAllgathervBench (uint64_t messageSize, Topology topology, const CMSB::CollectivesBench* reference)
+			: NeighborCollectivesBench (messageSize, topology, reference) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Neighbor_allgatherv"; }
+		virtual bool usesVCounts () const { return true; }
+	protected:
+		virtual void performMPICollectiveFunc () {
+			V_COUNT_CALL (Neighbor_allgatherv, (_benchInfo._sendBuff, _counts[0], _datatype,
+												_benchInfo._recvBuff, _counts, _displs, _datatype, _topoComm));
+		}
+	};
+
+	class NeighborAlltoallBench : public CMSB::NeighborCollectivesBench {
+	public:
+		NeighborAlltoallBench (uint64_t messageSize, Topology topology, const CMSB::CollectivesBench* reference)
+			: NeighborCollectivesBench (messageSize, topology, reference) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Neighbor_alltoall"; }
+	protected:
+		virtual void performMPICollectiveFunc () {
+			LARGE_COUNT_CALL (Neighbor_alltoall, (_benchInfo._sendBuff, _count, _datatype,
+												  _benchInfo._recvBuff, _count, _datatype, _topoComm));
+		}
+	};
+
+	class NeighborAlltoallvBench : public CMSB::NeighborCollectivesBench {
+	public:
+		NeighborAlltoallvBench (uint64_t messageSize, Topology topology, const CMSB::CollectivesBench* reference)
+			: NeighborCollectivesBench (messageSize, topology, reference) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Neighbor_alltoallv"; }
+		virtual bool usesVCounts () const { return true; }
+	protected:
+		virtual void performMPICollectiveFunc () {
+			V_COUNT_CALL (Neighbor_alltoallv, (_benchInfo._sendBuff, _counts, _displs, _datatype,
+											   _benchInfo._recvBuff, _counts, _displs, _datatype, _topoComm));
+		}
+	};
+
+	class NeighborAlltoallwBench : public CMSB::NeighborCollectivesBench {
+	public:
+		NeighborAlltoallwBench (uint64_t messageSize, Topology topology, const CMSB::CollectivesBench* reference)
+			: NeighborCollectivesBench (messageSize, topology, reference) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Neighbor_alltoallw"; }
+		virtual bool usesVCounts () const { return true; }
+	protected:
+		virtual void performMPICollectiveFunc () {
+			V_COUNT_CALL (Neighbor_alltoallw, (_benchInfo._sendBuff, _counts, _byteDispls, _types,
+											   _benchInfo._recvBuff, _counts, _byteDispls, _types, _topoComm));
+		}
+	};
+
+#endif
+
+}
+
+
+#endif   // __NEIGHBOR_BENCHES_H__
@@ -0,0 +1,118 @@
+#include <mpi.h>
+#include <iostream>
+#include <ios>
+#include <iomanip>
+#include <overheads/CartcreateBench.h>
+#include "NeighborCollectivesBench.h"
+#include "NeighborBenches.h"
+
+
+
+CMSB::NeighborCollectivesBench::NeighborCollectivesBench (uint64_t messageSize, Topology topology,
+														  const CMSB::CollectivesBench* reference) :
+	_topology		(topology),
+	_reference		(reference),
+	_topoComm		(MPI_COMM_NULL),
+	_numNeighbors	(0) {
+
+	_msgSize = messageSize;
+}
+
+CMSB::NeighborCollectivesBench::~NeighborCollectivesBench () {
+
+	freeTopology ();
+}
+
+void CMSB::NeighborCollectivesBench::init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo) {
+
+	CMSB::CollectivesBench::init (worldComm, benchInfo);
+	freeTopology ();
+
+	// The grid of CartcreateBench, but periodic so that every rank has
+	// all of its neighbors like in a stencil code
+	int dims[NUM_DIMS], periods[NUM_DIMS];
+	MPI_Comm cart_comm;
+	CMSB::CartcreateBench::computeDims (_numProcs, NUM_DIMS, dims, periods);
+	for (int d = 0; d < NUM_DIMS; d++) periods[d] = 1;
+	MPI_Cart_create (_worldComm, NUM_DIMS, dims, periods, 0, &cart_comm);
+
+	// The order of the neighbors of a Cartesian communicator
+	_numNeighbors = MAX_NEIGHBORS;
+	for (int d = 0; d < NUM_DIMS; d++) {
+		MPI_Cart_shift (cart_comm, d, 1, &_neighbors[2*d], &_neighbors[2*d+1]);
+	}
+	MPI_Aint lb, extent;
+	MPI_Type_get_extent (_datatype, &lb, &extent);
+	for (int k = 0; k < _numNeighbors; k++) {
+		_counts[k] = _count;
+		_displs[k] = k*_count;
+		_byteDispls[k] = (MPI_Aint)k * _count * extent;
+		_types[k] = _datatype;
+	}
+	// Only the v- and w-variants take int counts and displacements, and
+	// only before MPI 4
+#if MPI_VERSION < 4
+	_countOverflow = usesVCounts () && (MPI_Count)_numNeighbors * _count > INT_MAX;
+#endif
+	// A block per neighbor, also with fewer ranks than neighbors
+	if (!_countOverflow) {
+		uint64_t buff_len = (uint64_t)_numNeighbors * _count * extent;
+		reserveBuffers (buff_len, buff_len);
+	}
+
+	if (_topology == CARTESIAN) {
+		_topoComm = cart_comm;
+	}
+	else {
+		// Not reordered - the ranks of the grid are the ranks of worldComm
+		MPI_Dist_graph_create_adjacent (_worldComm, _numNeighbors, _neighbors, MPI_UNWEIGHTED,
+										_numNeighbors, _neighbors, MPI_UNWEIGHTED,
+										MPI_INFO_NULL, 0, &_topoComm);
+		MPI_Comm_free (&cart_comm);
+	}
+}
+
+void CMSB::NeighborCollectivesBench::runMicroBench (CMSB::TimeSyncInfo* syncInfo) {
+
+	if (skipOnCountOverflow ()) return;
+	CMSB::CollectivesBench::runMicroBench (syncInfo);
+
+	if (_myRank == 0 && _reference != NULL) {
+		std::cout << getResultLabel () << ": neighbor / halo = " << std::setprecision(6)
+				  << std::fixed << _avgRunTime / _reference->getMicroBenchResult () << std::endl;
+	}
+}
+
+std::string CMSB::NeighborCollectivesBench::getResultLabel () const {
+
+	return CMSB::CollectivesBench::getResultLabel () + ((_topology == CARTESIAN) ? "[cart]" : "[graph]");
+}
+
+void CMSB::NeighborCollectivesBench::freeTopology () {
+
+	if (_topoComm != MPI_COMM_NULL) {
+		MPI_Comm_free (&_topoComm);
+	}
+}
+
+void CMSB::createNeighborCollectiveMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc) {
+
+	// The halo exchange is the reference, so it runs first
+	CMSB::HaloExchangeBench* halo = new CMSB::HaloExchangeBench (messageSizePerProc);
+	benchmarks.push_back (halo);
+
+#if MPI_VERSION >= 3
+	const CMSB::NeighborCollectivesBench::Topology topologies[] = {
+		CMSB::NeighborCollectivesBench::CARTESIAN,
+		CMSB::NeighborCollectivesBench::DIST_GRAPH
+	};
+
+	for (int i = 0; i < 2; i++) {
+		benchmarks.push_back (new CMSB::NeighborAllgatherBench	(messageSizePerProc, topologies[i], halo));
+		benchmarks.push_back (new CMSB::NeighborAllgathervBench	(messageSizePerProc, topologies[i], halo));
+		benchmarks.push_back (new CMSB::NeighborAlltoallBench	(messageSizePerProc, topologies[i], halo));
+		benchmarks.push_back (new CMSB::NeighborAlltoallvBench	(messageSizePerProc, topologies[i], halo));
+		benchmarks.push_back (new CMSB::NeighborAlltoallwBench	(messageSizePerProc, topologies[i], halo));
+	}
+#endif
+}
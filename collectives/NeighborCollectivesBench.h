@@ -0,0 +1,61 @@
+#ifndef __NEIGHBOR_COLLECTIVES_BENCH_H__
+#define __NEIGHBOR_COLLECTIVES_BENCH_H__
+
+
+#include <mpi.h>
+#include <string>
+#include <vector>
+#include "CollectivesBench.h"
+
+
+namespace CMSB {
+
+	/**
+	 * Base class for the neighborhood collectives. The ranks form the
+	 * periodic 3D grid of CartcreateBench, either as a Cartesian
+	 * communicator or as a distributed graph with the same neighbors.
+	 * Every rank exchanges _msgSize doubles with each of its neighbors.
+	 * The results are compared with a hand-written halo exchange.
+	 */
+	class NeighborCollectivesBench : public CMSB::CollectivesBench {
+
+	public:
+
+		enum Topology {
+			CARTESIAN,
+			DIST_GRAPH
+		};
+
+		static const int NUM_DIMS = 3;
+		static const int MAX_NEIGHBORS = 2 * NUM_DIMS;
+
+		// The reference is not owned, it has to run before this benchmark
+		NeighborCollectivesBench  (uint64_t messageSize, Topology topology,
+								   const CMSB::CollectivesBench* reference = NULL);
+		virtual ~NeighborCollectivesBench ();
+
+		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
+		virtual void runMicroBench (CMSB::TimeSyncInfo* syncInfo);
+		virtual void writeResultToProfile () const { }
+		virtual unsigned int getMemConsumption () const { return sizeof (CMSB::NeighborCollectivesBench); }
+
+	protected:
+		virtual std::string getResultLabel () const;
+		void freeTopology ();
+
+		Topology		_topology;
+		const CMSB::CollectivesBench* _reference;
+		MPI_Comm		_topoComm;
+		int				_numNeighbors;
+		int				_neighbors[MAX_NEIGHBORS];	// -x, +x, -y, +y, -z, +z
+		CMSB::VCount	_counts[MAX_NEIGHBORS];
+		CMSB::VDispl	_displs[MAX_NEIGHBORS];		// In elements of _datatype
+		MPI_Aint		_byteDispls[MAX_NEIGHBORS];
+		MPI_Datatype	_types[MAX_NEIGHBORS];
+	};
+
+	void createNeighborCollectiveMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc);
+}
+
+
+#endif   // __NEIGHBOR_COLLECTIVES_BENCH_H__
@@ -0,0 +1,104 @@
+#ifndef __NONBLOCKING_BENCHES_H__
+#define __NONBLOCKING_BENCHES_H__
+
+
+#include <mpi.h>
+#include "NonblockingCollectivesBench.h"
+
+
+namespace CMSB {
+
+#if MPI_VERSION >= 3
+
+	class IbarrierBench : public CMSB::NonblockingCollectivesBench {
+	public:
+		IbarrierBench () : NonblockingCollectivesBench (0) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Ibarrier"; }
+	protected:
+		virtual void postMPICollectiveFunc (MPI_Request* request) {
+			MPI_Ibarrier (_worldComm, request);
+		}
+	};
+
+	class IbcastBench : public CMSB::NonblockingCollectivesBench {
+	public:
+		IbcastBench (uint64_t messageSize) : NonblockingCollectivesBench (messageSize) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Ibcast"; }
+	protected:
+		virtual void postMPICollectiveFunc (MPI_Request* request) {
+			LARGE_COUNT_CALL (Ibcast, (_benchInfo._sendBuff, _count, _datatype, 0, _worldComm, request));
+		}
+	};
+
+	class IreduceBench : public CMSB::NonblockingCollectivesBench {
+	public:
+		IreduceBench (uint64_t messageSize) : NonblockingCollectivesBench (messageSize) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Ireduce"; }
+	protected:
+		virtual void postMPICollectiveFunc (MPI_Request* request) {
+			LARGE_COUNT_CALL (Ireduce, (_benchInfo._sendBuff, _benchInfo._recvBuff, _count, _datatype, _op, 0,
+				_worldComm, request));
+		}
+	};
+
+	class IallreduceBench : public CMSB::NonblockingCollectivesBench {
+	public:
+		IallreduceBench (uint64_t messageSize) : NonblockingCollectivesBench (messageSize) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Iallreduce"; }
+	protected:
+		virtual void postMPICollectiveFunc (MPI_Request* request) {
+			LARGE_COUNT_CALL (Iallreduce, (_benchInfo._sendBuff, _benchInfo._recvBuff, _count, _datatype, _op,
+				_worldComm, request));
+		}
+	};
+
+	class IgatherBench : public CMSB::NonblockingCollectivesBench {
+	public:
+		IgatherBench (uint64_t messageSize) : NonblockingCollectivesBench (messageSize) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Igather"; }
+	protected:
+		virtual void postMPICollectiveFunc (MPI_Request* request) {
+			LARGE_COUNT_CALL (Igather, (_benchInfo._sendBuff, _count, _datatype, _benchInfo._recvBuff, _count, _datatype,
+				0, _worldComm, request));
+		}
+	};
+
+	class IscatterBench : public CMSB::NonblockingCollectivesBench {
+	public:
+		IscatterBench (uint64_t messageSize) : NonblockingCollectivesBench (messageSize) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Iscatter"; }
+	protected:
+		virtual void postMPICollectiveFunc (MPI_Request* request) {
+			LARGE_COUNT_CALL (Iscatter, (_benchInfo._sendBuff, _count, _datatype, _benchInfo._recvBuff, _count, _datatype,
+				0, _worldComm, request));
+		}
+	};
+
+	class IallgatherBench : public CMSB::NonblockingCollectivesBench {
+	public:
+		IallgatherBench (uint64_t messageSize) : NonblockingCollectivesBench (messageSize) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Iallgather"; }
+	protected:
+		virtual void postMPICollectiveFunc (MPI_Request* request) {
+			LARGE_COUNT_CALL (Iallgather, (_benchInfo._sendBuff, _count, _datatype, _benchInfo._recvBuff, _count, _datatype,
+				_worldComm, request));
+		}
+	};
+
+	class IalltoallBench : public CMSB::NonblockingCollectivesBench {
+	public:
+		IalltoallBench (uint64_t messageSize) : NonblockingCollectivesBench (messageSize) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Ialltoall"; }
+	protected:
+		virtual void postMPICollectiveFunc (MPI_Request* request) {
+			LARGE_COUNT_CALL (Ialltoall, (_benchInfo._sendBuff, _count, _datatype, _benchInfo._recvBuff, _count, _datatype,
+				_worldComm, request));
+		}
+	};
+
+#endif
+
+}
+
+
+#endif   // __NONBLOCKING_BENCHES_H__
@@ -0,0 +1,149 @@
+#include <mpi.h>
+#include <iostream>
+#include <ios>
+#include <iomanip>
+#include <sstream>
+#include <timing/elg_pform_defs.h>
+#include "NonblockingCollectivesBench.h"
+#include "NonblockingBenches.h"
+
+
+CMSB::NonblockingCollectivesBench::NonblockingCollectivesBench (uint64_t messageSize, int numTestPolls) :
+	_overlap		(false),
+	_numPolls		(0),
+	_numTestPolls	(numTestPolls),
+	_computeUnits	(0),
+	_postTimeSum	(0.0),
+	_waitTimeSum	(0.0),
+	_numCalls		(0) {
+
+	_msgSize = messageSize;
+}
+
+CMSB::NonblockingCollectivesBench::~NonblockingCollectivesBench () {
+}
+
+void CMSB::NonblockingCollectivesBench::runMicroBench (CMSB::TimeSyncInfo* syncInfo) {
+
+	double pure_time, compute_time, local_compute_time;
+
+	// Pure latency - post and wait right away
+	_overlap = false;
+	_numPolls = 0;
+	_postTimeSum = _waitTimeSum = 0.0;
+	_numCalls = 0;
+	CMSB::CollectivesBench::runMicroBench (syncInfo);
+	printPostWaitTimes ();
+	pure_time = _avgRunTime;
+	MPI_Bcast (&pure_time, 1, MPI_DOUBLE, 0, _worldComm);
+
+	// The kernel takes as long as the collective on every rank
+	_computeUnits = _kernel.calibrate (pure_time * 1e-6);
+	local_compute_time = _kernel.time (_computeUnits, NUM_WARMPUP_ITERS) * 1e6;	// Convert to usec
+	MPI_Allreduce (&local_compute_time, &compute_time, 1, MPI_DOUBLE, MPI_MAX, _worldComm);
+
+	// Overlap without and with progress polls
+	_overlap = true;
+	for (int variant = 0; variant < 2; variant++) {
+		_numPolls = (variant == 0) ? 0 : _numTestPolls;
+		if (variant > 0 && _numTestPolls == 0) break;
+
+		_postTimeSum = _waitTimeSum = 0.0;
+		_numCalls = 0;
+		CMSB::CollectivesBench::runMicroBench (syncInfo);
+		printPostWaitTimes ();
+
+		if (_myRank == 0) {
+			// 1 if the collective completes entirely behind the kernel
+			double ratio = 1.0 - (_avgRunTime - compute_time) / pure_time;
+			if (ratio < 0.0) ratio = 0.0;
+			if (ratio > 1.0) ratio = 1.0;
+			std::cout << getResultLabel () << ": compute time = " << std::setprecision(6)
+					  << std::fixed << compute_time << std::endl;
+			std::cout << getResultLabel () << ": overlap ratio = " << std::setprecision(6)
+					  << std::fixed << ratio << std::endl;
+		}
+	}
+
+	_overlap = false;
+	_numPolls = 0;
+	_avgRunTime = pure_time;
+}
+
+void CMSB::NonblockingCollectivesBench::performMPICollectiveFunc () {
+
+	MPI_Request request;
+	int flag;
+
+	double post_time = CMSB::elg_pform_wtime ();
+	postMPICollectiveFunc (&request);
+	double compute_time = CMSB::elg_pform_wtime ();
+	if (_overlap) {
+		// The polls split the kernel into equal chunks
+		unsigned int chunk = _computeUnits / (_numPolls+1);
+		for (int i = 0; i <= _numPolls; i++) {
+			_kernel.run (chunk);
+			if (i < _numPolls) MPI_Test (&request, &flag, MPI_STATUS_IGNORE);
+		}
+	}
+	double wait_time = CMSB::elg_pform_wtime ();
+	MPI_Wait (&request, MPI_STATUS_IGNORE);
+	double end_time = CMSB::elg_pform_wtime ();
+
+	// Only the iterations of the rounds count, like their run times
+	if (_roundIter >= 0) {
+		_postTimes[_roundIter] = compute_time - post_time;
+		_waitTimes[_roundIter] = end_time - wait_time;
+	}
+}
+
+void CMSB::NonblockingCollectivesBench::keepIterations (const int* iters, int numIters) {
+
+	for (int i = 0; i < numIters; i++) {
+		_postTimeSum += _postTimes[iters[i]];
+		_waitTimeSum += _waitTimes[iters[i]];
+	}
+	_numCalls += numIters;
+}
+
+std::string CMSB::NonblockingCollectivesBench::getResultLabel () const {
+
+	std::ostringstream label;
+	label << CMSB::CollectivesBench::getResultLabel ();
+	if (_overlap) {
+		label << "[overlap";
+		if (_numPolls > 0) label << ",test=" << _numPolls;
+		label << "]";
+	}
+	return label.str ();
+}
+
+void CMSB::NonblockingCollectivesBench::printPostWaitTimes () {
+
+	// Mean per call in usec, the slowest rank counts
+	double times[2], max_times[2];
+	times[0] = (_numCalls > 0) ? _postTimeSum / _numCalls * 1e6 : 0.0;
+	times[1] = (_numCalls > 0) ? _waitTimeSum / _numCalls * 1e6 : 0.0;
+	MPI_Reduce (times, max_times, 2, MPI_DOUBLE, MPI_MAX, 0, _worldComm);
+
+	if (_myRank == 0) {
+		std::cout << getResultLabel () << ": post time = " << std::setprecision(6)
+				  << std::fixed << max_times[0] << std::endl;
+		std::cout << getResultLabel () << ": wait time = " << std::setprecision(6)
+				  << std::fixed << max_times[1] << std::endl;
+	}
+}
+
+void CMSB::createNonblockingCollectiveMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc) {
+
+#if MPI_VERSION >= 3
+	benchmarks.push_back (new CMSB::IbarrierBench	());
+	benchmarks.push_back (new CMSB::IbcastBench		(messageSizePerProc));
+	benchmarks.push_back (new CMSB::IreduceBench	(messageSizePerProc));
+	benchmarks.push_back (new CMSB::IallreduceBench	(messageSizePerProc));
+	benchmarks.push_back (new CMSB::IgatherBench	(messageSizePerProc));
+	benchmarks.push_back (new CMSB::IscatterBench	(messageSizePerProc));
+	benchmarks.push_back (new CMSB::IallgatherBench	(messageSizePerProc));
+	benchmarks.push_back (new CMSB::IalltoallBench	(messageSizePerProc));
+#endif
+}
@@ -0,0 +1,61 @@
+#ifndef __NONBLOCKING_COLLECTIVES_BENCH_H__
+#define __NONBLOCKING_COLLECTIVES_BENCH_H__
+
+
+#include <mpi.h>
+#include <string>
+#include <vector>
+#include <util/ComputeKernel.h>
+#include "CollectivesBench.h"
+
+
+namespace CMSB {
+
+	/**
+	 * Base class for the nonblocking collectives. Every collective is
+	 * measured three times: posted and waited for at once (pure latency),
+	 * with a compute kernel of the length of the pure latency between the
+	 * post and the wait, and with the kernel interrupted by MPI_Test polls.
+	 * The overlap ratio is the share of the pure latency hidden behind
+	 * the computation.
+	 */
+	class NonblockingCollectivesBench : public CMSB::CollectivesBench {
+
+	public:
+
+		// Number of MPI_Test calls spread over the compute kernel
+		static const int NUM_TEST_POLLS = 8;
+
+		NonblockingCollectivesBench  (uint64_t messageSize, int numTestPolls = NUM_TEST_POLLS);
+		virtual ~NonblockingCollectivesBench ();
+
+		virtual void runMicroBench (CMSB::TimeSyncInfo* syncInfo);
+		virtual void writeResultToProfile () const { }
+		virtual unsigned int getMemConsumption () const { return sizeof (CMSB::NonblockingCollectivesBench); }
+
+	protected:
+		virtual void postMPICollectiveFunc (MPI_Request* request) = 0;
+		virtual void performMPICollectiveFunc ();
+		virtual void keepIterations (const int* iters, int numIters);
+		virtual std::string getResultLabel () const;
+
+		void printPostWaitTimes ();
+
+		bool			_overlap;			// Compute between post and wait
+		int				_numPolls;			// MPI_Test calls during the computation
+		int				_numTestPolls;
+		unsigned int	_computeUnits;
+		CMSB::ComputeKernel	_kernel;
+		// Post and wait of the iterations of the current round in sec
+		double			_postTimes[NUM_ITERS_ROUND];
+		double			_waitTimes[NUM_ITERS_ROUND];
+		double			_postTimeSum;		// Over the valid iterations
+		double			_waitTimeSum;
+		int				_numCalls;
+	};
+
+	void createNonblockingCollectiveMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc);
+}
+
+
+#endif   // __NONBLOCKING_COLLECTIVES_BENCH_H__
@@ -0,0 +1,238 @@
+#ifndef __PERSISTENT_BENCHES_H__
+#define __PERSISTENT_BENCHES_H__
+
+
+#include <mpi.h>
+#include "PersistentCollectivesBench.h"
+#include "AllgatherBench.h"
+#include "AllgathervBench.h"
+#include "AllreduceBench.h"
+#include "AlltoallBench.h"
+#include "AlltoallvBench.h"
+#include "BcastBench.h"
+#include "ExscanBench.h"
+#include "GatherBench.h"
+#include "GathervBench.h"
+#include "ReduceBench.h"
+#include "ReduceScatterBench.h"
+#include "ReduceScatterBlockBench.h"
+#include "ScanBench.h"
+#include "ScatterBench.h"
+#include "ScattervBench.h"
+
+
+namespace CMSB {
+
+#ifdef PERSISTENT_COLL_INIT
+
+	class AllgatherInitBench : public CMSB::PersistentCollectivesBench {
+	public:
+		AllgatherInitBench (uint64_t messageSize)
+			: PersistentCollectivesBench (new CMSB::AllgatherBench (messageSize), messageSize) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Allgather_init"; }
+	protected:
+		virtual void initMPICollectiveFunc (MPI_Request* request) {
+			LARGE_COUNT_COLL_INIT (Allgather, (
+				_benchInfo._sendBuff, _count, _datatype, _benchInfo._recvBuff, _count, _datatype,
+				_worldComm,
+				MPI_INFO_NULL, request));
+		}
+	};
+
+	class AllgathervInitBench : public CMSB::PersistentCollectivesBench {
+	public:
+		AllgathervInitBench (uint64_t messageSize)
+			: PersistentCollectivesBench (new CMSB::AllgathervBench (messageSize), messageSize) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Allgatherv_init"; }
+	protected:
+		virtual void initMPICollectiveFunc (MPI_Request* request) {
+			V_COUNT_COLL_INIT (Allgatherv, (
+				_benchInfo._sendBuff, _blockCounts[_myRank], _datatype, _benchInfo._recvBuff, &_blockCounts[0],
+				&_blockDispls[0], _datatype, _worldComm,
+				MPI_INFO_NULL, request));
+		}
+	};
+
+	class AllreduceInitBench : public CMSB::PersistentCollectivesBench {
+	public:
+		AllreduceInitBench (uint64_t messageSize)
+			: PersistentCollectivesBench (new CMSB::AllreduceBench (messageSize), messageSize) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Allreduce_init"; }
+	protected:
+		virtual void initMPICollectiveFunc (MPI_Request* request) {
+			LARGE_COUNT_COLL_INIT (Allreduce, (
+				_benchInfo._sendBuff, _benchInfo._recvBuff, _count, _datatype, _op, _worldComm,
+				MPI_INFO_NULL, request));
+		}
+	};
+
+	class AlltoallInitBench : public CMSB::PersistentCollectivesBench {
+	public:
+		AlltoallInitBench (uint64_t messageSize)
+			: PersistentCollectivesBench (new CMSB::AlltoallBench (messageSize), messageSize) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Alltoall_init"; }
+	protected:
+		virtual void initMPICollectiveFunc (MPI_Request* request) {
+			LARGE_COUNT_COLL_INIT (Alltoall, (
+				_benchInfo._sendBuff, _count, _datatype, _benchInfo._recvBuff, _count, _datatype,
+				_worldComm,
+				MPI_INFO_NULL, request));
+		}
+	};
+
+	class AlltoallvInitBench : public CMSB::PersistentCollectivesBench {
+	public:
+		AlltoallvInitBench (uint64_t messageSize)
+			: PersistentCollectivesBench (new CMSB::AlltoallvBench (messageSize), messageSize) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Alltoallv_init"; }
+	protected:
+		virtual void initMPICollectiveFunc (MPI_Request* request) {
+			V_COUNT_COLL_INIT (Alltoallv, (
+				_benchInfo._sendBuff, _benchInfo._sendCounts, _benchInfo._sendDispls, _datatype,
+				_benchInfo._recvBuff, _benchInfo._recvCounts, _benchInfo._recvDispls, _datatype,
+				_worldComm,
+				MPI_INFO_NULL, request));
+		}
+	};
+
+	class BcastInitBench : public CMSB::PersistentCollectivesBench {
+	public:
+		BcastInitBench (uint64_t messageSize)
+			: PersistentCollectivesBench (new CMSB::BcastBench (messageSize), messageSize) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Bcast_init"; }
+	protected:
+		virtual void initMPICollectiveFunc (MPI_Request* request) {
+			LARGE_COUNT_COLL_INIT (Bcast, (
+				_benchInfo._sendBuff, _count, _datatype, 0, _worldComm,
+				MPI_INFO_NULL, request));
+		}
+	};
+
+	class ExscanInitBench : public CMSB::PersistentCollectivesBench {
+	public:
+		ExscanInitBench (uint64_t messageSize)
+			: PersistentCollectivesBench (new CMSB::ExscanBench (messageSize), messageSize) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Exscan_init"; }
+	protected:
+		virtual void initMPICollectiveFunc (MPI_Request* request) {
+			LARGE_COUNT_COLL_INIT (Exscan, (
+				_benchInfo._sendBuff, _benchInfo._recvBuff, _count, _datatype, _op, _worldComm,
+				MPI_INFO_NULL, request));
+		}
+	};
+
+	class GatherInitBench : public CMSB::PersistentCollectivesBench {
+	public:
+		GatherInitBench (uint64_t messageSize)
+			: PersistentCollectivesBench (new CMSB::GatherBench (messageSize), messageSize) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Gather_init"; }
+	protected:
+		virtual void initMPICollectiveFunc (MPI_Request* request) {
+			LARGE_COUNT_COLL_INIT (Gather, (
+				_benchInfo._sendBuff, _count, _datatype, _benchInfo._recvBuff, _count, _datatype,
+				0, _worldComm,
+				MPI_INFO_NULL, request));
+		}
+	};
+
+	class GathervInitBench : public CMSB::PersistentCollectivesBench {
+	public:
+		GathervInitBench (uint64_t messageSize)
+			: PersistentCollectivesBench (new CMSB::GathervBench (messageSize), messageSize) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Gatherv_init"; }
+	protected:
+		virtual void initMPICollectiveFunc (MPI_Request* request) {
+			V_COUNT_COLL_INIT (Gatherv, (
+				_benchInfo._sendBuff, _blockCounts[_myRank], _datatype, _benchInfo._recvBuff, &_blockCounts[0],
+				&_blockDispls[0], _datatype, 0, _worldComm,
+				MPI_INFO_NULL, request));
+		}
+	};
+
+	class ReduceInitBench : public CMSB::PersistentCollectivesBench {
+	public:
+		ReduceInitBench (uint64_t messageSize)
+			: PersistentCollectivesBench (new CMSB::ReduceBench (messageSize), messageSize) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Reduce_init"; }
+	protected:
+		virtual void initMPICollectiveFunc (MPI_Request* request) {
+			LARGE_COUNT_COLL_INIT (Reduce, (
+				_benchInfo._sendBuff, _benchInfo._recvBuff, _count, _datatype, _op, 0, _worldComm,
+				MPI_INFO_NULL, request));
+		}
+	};
+
+	class ReduceScatterInitBench : public CMSB::PersistentCollectivesBench {
+	public:
+		ReduceScatterInitBench (uint64_t messageSize)
+			: PersistentCollectivesBench (new CMSB::ReduceScatterBench (messageSize), messageSize) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Reduce_scatter_init"; }
+	protected:
+		virtual void initMPICollectiveFunc (MPI_Request* request) {
+			V_COUNT_COLL_INIT (Reduce_scatter, (
+				_benchInfo._sendBuff, _benchInfo._recvBuff, &_blockCounts[0], _datatype, _op,
+				_worldComm,
+				MPI_INFO_NULL, request));
+		}
+	};
+
+	class ReduceScatterBlockInitBench : public CMSB::PersistentCollectivesBench {
+	public:
+		ReduceScatterBlockInitBench (uint64_t messageSize)
+			: PersistentCollectivesBench (new CMSB::ReduceScatterBlockBench (messageSize), messageSize) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Reduce_scatter_block_init"; }
+	protected:
+		virtual void initMPICollectiveFunc (MPI_Request* request) {
+			LARGE_COUNT_COLL_INIT (Reduce_scatter_block, (
+				_benchInfo._sendBuff, _benchInfo._recvBuff, _count, _datatype, _op, _worldComm,
+				MPI_INFO_NULL, request));
+		}
+	};
+
+	class ScanInitBench : public CMSB::PersistentCollectivesBench {
+	public:
+		ScanInitBench (uint64_t messageSize)
+			: PersistentCollectivesBench (new CMSB::ScanBench (messageSize), messageSize) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Scan_init"; }
+	protected:
+		virtual void initMPICollectiveFunc (MPI_Request* request) {
+			LARGE_COUNT_COLL_INIT (Scan, (
+				_benchInfo._sendBuff, _benchInfo._recvBuff, _count, _datatype, _op, _worldComm,
+				MPI_INFO_NULL, request));
+		}
+	};
+
+	class ScatterInitBench : public CMSB::PersistentCollectivesBench {
+	public:
+		ScatterInitBench (uint64_t messageSize)
+			: PersistentCollectivesBench (new CMSB::ScatterBench (messageSize), messageSize) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Scatter_init"; }
+	protected:
+		virtual void initMPICollectiveFunc (MPI_Request* request) {
+			LARGE_COUNT_COLL_INIT (Scatter, (
+				_benchInfo._sendBuff, _count, _datatype, _benchInfo._recvBuff, _count, _datatype,
+				0, _worldComm,
+				MPI_INFO_NULL, request));
+		}
+	};
+
+	class ScattervInitBench : public CMSB::PersistentCollectivesBench {
+	public:
+		ScattervInitBench (uint64_t messageSize)
+			: PersistentCollectivesBench (new CMSB::ScattervBench (messageSize), messageSize) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Scatterv_init"; }
+	protected:
+		virtual void initMPICollectiveFunc (MPI_Request* request) {
+			V_COUNT_COLL_INIT (Scatterv, (
+				_benchInfo._sendBuff, &_blockCounts[0], &_blockDispls[0], _datatype,
+				_benchInfo._recvBuff, _blockCounts[_myRank], _datatype, 0, _worldComm,
+				MPI_INFO_NULL, request));
+		}
+	};
+
+#endif
+
+}
+
+
+#endif   // __PERSISTENT_BENCHES_H__
@@ -0,0 +1,101 @@
+#include <mpi.h>
+#include <iostream>
+#include <ios>
+#include <iomanip>
+#include <timing/elg_pform_defs.h>
+#include "PersistentCollectivesBench.h"
+#include "PersistentBenches.h"
+
+
+
+CMSB::PersistentCollectivesBench::PersistentCollectivesBench (CMSB::CollectivesBench* blockingBench, uint64_t messageSize) :
+	_blockingBench	(blockingBench),
+	_request		(MPI_REQUEST_NULL),
+	_initTime		(0.0) {
+
+	_msgSize = messageSize;
+}
+
+CMSB::PersistentCollectivesBench::~PersistentCollectivesBench () {
+
+	delete _blockingBench;
+}
+
+void CMSB::PersistentCollectivesBench::init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo) {
+
+	CMSB::CollectivesBench::init (worldComm, benchInfo);
+	_blockingBench->init (worldComm, benchInfo);
+}
+
+void CMSB::PersistentCollectivesBench::runMicroBench (CMSB::TimeSyncInfo* syncInfo) {
+
+	double init_time = 0.0;
+	std::string label (getResultLabel ());
+
+	if (skipOnCountOverflow ()) return;
+
+	// Blocking reference at the same size
+	_blockingBench->runMicroBench (syncInfo);
+
+	// Initialization on its own, the slowest rank counts
+	for (int i = 0; i < NUM_INIT_ITERS; i++) {
+		MPI_Barrier (_worldComm);
+		double start_time = CMSB::elg_pform_wtime ();
+		initMPICollectiveFunc (&_request);
+		init_time += CMSB::elg_pform_wtime () - start_time;
+		MPI_Request_free (&_request);
+	}
+	init_time = init_time / NUM_INIT_ITERS * 1e6;	// Convert to usec
+	MPI_Allreduce (&init_time, &_initTime, 1, MPI_DOUBLE, MPI_MAX, _worldComm);
+
+	// Steady state - one request started over and over
+	initMPICollectiveFunc (&_request);
+	CMSB::CollectivesBench::runMicroBench (syncInfo);
+	MPI_Request_free (&_request);
+
+	if (_myRank == 0) {
+		double blocking_time = _blockingBench->getMicroBenchResult ();
+		std::cout << label << ": init time = " << std::setprecision(6)
+				  << std::fixed << _initTime << std::endl;
+		std::cout << label << ": blocking median = " << std::setprecision(6)
+				  << std::fixed << blocking_time << std::endl;
+		std::cout << label << ": persistent / blocking = " << std::setprecision(6)
+				  << std::fixed << _avgRunTime / blocking_time << std::endl;
+		// Calls after which the init is paid back by the faster calls
+		std::cout << label << ": break-even calls = ";
+		if (_avgRunTime < blocking_time) {
+			std::cout << std::setprecision(1) << std::fixed
+					  << _initTime / (blocking_time - _avgRunTime) << std::endl;
+		}
+		else {
+			std::cout << "never" << std::endl;
+		}
+	}
+}
+
+void CMSB::PersistentCollectivesBench::performMPICollectiveFunc () {
+
+	MPI_Start (&_request);
+	MPI_Wait (&_request, MPI_STATUS_IGNORE);
+}
+
+void CMSB::createPersistentCollectiveMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc) {
+
+#ifdef PERSISTENT_COLL_INIT
+	benchmarks.push_back (new CMSB::AllgatherInitBench		(messageSizePerProc));
+	benchmarks.push_back (new CMSB::AllgathervInitBench		(messageSizePerProc));
+	benchmarks.push_back (new CMSB::AllreduceInitBench		(messageSizePerProc));
+	benchmarks.push_back (new CMSB::AlltoallInitBench		(messageSizePerProc));
+	benchmarks.push_back (new CMSB::AlltoallvInitBench		(messageSizePerProc));
+	benchmarks.push_back (new CMSB::BcastInitBench			(messageSizePerProc));
+	benchmarks.push_back (new CMSB::ExscanInitBench			(messageSizePerProc));
+	benchmarks.push_back (new CMSB::GatherInitBench			(messageSizePerProc));
+	benchmarks.push_back (new CMSB::GathervInitBench		(messageSizePerProc));
+	benchmarks.push_back (new CMSB::ReduceInitBench			(messageSizePerProc));
+	benchmarks.push_back (new CMSB::ReduceScatterInitBench	(messageSizePerProc));
+	benchmarks.push_back (new CMSB::ReduceScatterBlockInitBench (messageSizePerProc));
+	benchmarks.push_back (new CMSB::ScanInitBench			(messageSizePerProc));
+	benchmarks.push_back (new CMSB::ScatterInitBench		(messageSizePerProc));
+	benchmarks.push_back (new CMSB::ScattervInitBench		(messageSizePerProc));
+#endif
+}
@@ -0,0 +1,67 @@
+#ifndef __PERSISTENT_COLLECTIVES_BENCH_H__
+#define __PERSISTENT_COLLECTIVES_BENCH_H__
+
+
+#include <mpi.h>
+#include <vector>
+#include "CollectivesBench.h"
+
+// Persistent collectives are part of MPI-4, Open MPI offers them before
+// as an extension. The v-collectives are called like V_COUNT_CALL, the
+// others like LARGE_COUNT_CALL.
+#if MPI_VERSION >= 4
+#define PERSISTENT_COLL_INIT(name) MPI_##name##_init
+#define LARGE_COUNT_COLL_INIT(name, args) LARGE_COUNT_CALL (name##_init, args)
+#define V_COUNT_COLL_INIT(name, args) V_COUNT_CALL (name##_init, args)
+#elif defined(OPEN_MPI)
+#include <mpi-ext.h>
+#ifdef OMPI_HAVE_MPI_EXT_PCOLLREQ
+#define PERSISTENT_COLL_INIT(name) MPIX_##name##_init
+#define LARGE_COUNT_COLL_INIT(name, args) MPIX_##name##_init args
+#define V_COUNT_COLL_INIT(name, args) MPIX_##name##_init args
+#endif
+#endif
+
+
+namespace CMSB {
+
+	/**
+	 * Base class for the persistent collectives. The initialization is
+	 * timed on its own, the steady state is MPI_Start plus MPI_Wait of one
+	 * request. The blocking counterpart is run right before at the same
+	 * size, so that the number of calls after which the initialization
+	 * pays off can be reported.
+	 */
+	class PersistentCollectivesBench : public CMSB::CollectivesBench {
+
+	public:
+
+		// Initializations timed to get the init time
+		static const int NUM_INIT_ITERS = 10;
+
+		// Takes ownership of the blocking benchmark
+		PersistentCollectivesBench  (CMSB::CollectivesBench* blockingBench, uint64_t messageSize);
+		virtual ~PersistentCollectivesBench ();
+
+		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
+		virtual void runMicroBench (CMSB::TimeSyncInfo* syncInfo);
+		virtual void writeResultToProfile () const { }
+		virtual bool usesVCounts () const { return _blockingBench->usesVCounts (); }
+		virtual unsigned int getMemConsumption () const {
+			return sizeof (CMSB::PersistentCollectivesBench) + _blockingBench->getMemConsumption ();
+		}
+
+	protected:
+		virtual void initMPICollectiveFunc (MPI_Request* request) = 0;
+		virtual void performMPICollectiveFunc ();
+
+		CMSB::CollectivesBench*	_blockingBench;
+		MPI_Request				_request;
+		double					_initTime;		// In usec
+	};
+
+	void createPersistentCollectiveMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc);
+}
+
+
+#endif   // __PERSISTENT_COLLECTIVES_BENCH_H__
@@ -1,6 +1,5 @@
 #include <cmath>
 #include <cstring>
-#include <iostream>
 #include <mpi.h>
 #include "ReduceAltBench.h"
 
@@ -18,7 +17,7 @@ SCOREP_USER_METRIC_LOCAL (bench_ReduceAltBench_metric);
 #endif
 
 
-CMSB::ReduceAltBench::ReduceAltBench (unsigned int messageSize) {
+CMSB::ReduceAltBench::ReduceAltBench (uint64_t messageSize) {
 
     _msgSize = messageSize;
     _tempBuff = new double[_msgSize];
@@ -32,6 +31,8 @@ CMSB::ReduceAltBench::~ReduceAltBench () {
 void CMSB::ReduceAltBench::init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo) {
 
 	CMSB::CollectivesBench::init (worldComm, benchInfo);
+	// The messages of the tree are plain doubles with an int count
+	_countOverflow = (_msgSize > INT_MAX);
 #ifdef USE_SCOREP
     SCOREP_USER_METRIC_INIT (bench_ReduceAltBench_metric, "ReduceAlt timing", "usec",
                              SCOREP_USER_METRIC_TYPE_DOUBLE, SCOREP_USER_METRIC_CONTEXT_GLOBAL);
@@ -55,7 +56,7 @@ void CMSB::ReduceAltBench::writeResultToProfile () const {
 void CMSB::ReduceAltBench::performMPICollectiveFunc () {
 	
 	// Alternative implementation of MPI_Reduce.
-	// Invoked as: MPI_Reduce (_benchInfo._sendBuff, _benchInfo._recvBuff, _msgSize, MPI_DOUBLE, MPI_SUM, 0, _worldComm)
+	// Invoked as: MPI_Reduce (_benchInfo._sendBuff, _benchInfo._recvBuff, _msgSize, MPI_DOUBLE, MPI_SUM, _root, _worldComm)
 	// Uses MST implementation to get a clear expectation how much time reduce operation will take.
 	// The expected model: log(P)*[alpha+N*beta+N*gamma],
 	// where p - number of processes, N - message size in bytes, alpha - latency, beta -
@@ -66,17 +67,7 @@ void CMSB::ReduceAltBench::performMPICollectiveFunc () {
 	// algorithms exist.
 	
 	std::memcpy (_benchInfo._recvBuff, _benchInfo._sendBuff, _msgSize*sizeof(double));
-	reduceAltImpl (0, 0, _numProcs-1);
-	
-	// Check for correctness of the operation - every rank should have the root's buffer, which
-	// contains ones
-	if (_myRank == 0) {
-		std::cout << "ReduceAltBench - rank " << _myRank << ": ";
-		for (int i = 0; i < _msgSize; i++) {
-			std::cout << _benchInfo._recvBuff[i] << "  ";
-		}
-		std::cout << std::endl;
-	}
+	reduceAltImpl (_root, 0, _numProcs-1);
 }
 
 void CMSB::ReduceAltBench::reduceAltImpl (int root, int left, int right) {
@@ -103,7 +94,7 @@ void CMSB::ReduceAltBench::reduceAltImpl (int root, int left, int right) {
 	if (_myRank == root) {
 		MPI_Status status;
 		MPI_Recv (_tempBuff, _msgSize, MPI_DOUBLE, src, 0, _worldComm, &status);
-		for (int i = 0; i < _msgSize; i++) {
+		for (uint64_t i = 0; i < _msgSize; i++) {
 			_benchInfo._recvBuff[i] += _tempBuff[i];
 		}
 	}
@@ -14,7 +14,7 @@ namespace CMSB {
 
 	public:
 
-		ReduceAltBench  (unsigned int messageSize);
+		ReduceAltBench  (uint64_t messageSize);
 		virtual ~ReduceAltBench ();
 		
 		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
@@ -15,7 +15,7 @@ SCOREP_USER_METRIC_LOCAL (bench_ReduceBench_metric);
 #endif
 
 
-CMSB::ReduceBench::ReduceBench (unsigned int messageSize) {
+CMSB::ReduceBench::ReduceBench (uint64_t messageSize) {
 
     _msgSize = messageSize;
 }
@@ -14,7 +14,7 @@ namespace CMSB {
 
 	public:
 
-		ReduceBench  (unsigned int messageSize);
+		ReduceBench  (uint64_t messageSize);
 		virtual ~ReduceBench ();
 		
 		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
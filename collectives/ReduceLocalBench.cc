@@ -0,0 +1,49 @@
+#include <mpi.h>
+#include "ReduceLocalBench.h"
+
+#ifdef USE_SCOREP
+#include <scorep/SCOREP_User.h>
+#endif
+
+
+
+
+//======================================================================
+
+#ifdef USE_SCOREP
+SCOREP_USER_METRIC_LOCAL (bench_ReduceLocalBench_metric);
+#endif
+
+
+CMSB::ReduceLocalBench::ReduceLocalBench (uint64_t messageSize) {
+
+    _msgSize = messageSize;
+}
+
+CMSB::ReduceLocalBench::~ReduceLocalBench () {
+}
+
+void CMSB::ReduceLocalBench::init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo) {
+
+	CMSB::CollectivesBench::init (worldComm, benchInfo);
+#ifdef USE_SCOREP
+    SCOREP_USER_METRIC_INIT (bench_ReduceLocalBench_metric, "ReduceLocal timing", "usec",
+                             SCOREP_USER_METRIC_TYPE_DOUBLE, SCOREP_USER_METRIC_CONTEXT_GLOBAL);
+#endif
+}
+
+const char* CMSB::ReduceLocalBench::getMicroBenchName () const {
+
+    return "MPI_ReduceLocal";
+}
+
+void CMSB::ReduceLocalBench::writeResultToProfile () const {
+
+#ifdef USE_SCOREP
+	if (_myRank == 0) {		// Only one rank should update SCORE-P's metrics
+		SCOREP_USER_METRIC_DOUBLE (bench_ReduceLocalBench_metric, getMicroBenchResult ());
+	}
+#endif
+}
+
+//======================================================================
@@ -0,0 +1,32 @@
+#ifndef __ReduceLocal_BENCH_H__
+#define __ReduceLocal_BENCH_H__
+
+
+#include "CollectivesBench.h"
+
+
+namespace CMSB {
+
+	/**
+	 * Represents ReduceLocal benchmark.
+	 */
+	class ReduceLocalBench : public CMSB::CollectivesBench {
+
+	public:
+
+		ReduceLocalBench  (uint64_t messageSize);
+		virtual ~ReduceLocalBench ();
+		
+		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
+        virtual const char* getMicroBenchName () const;
+		virtual void writeResultToProfile () const;
+		virtual bool isLocalReduction () const { return true; }
+
+	protected:
+		virtual void performMPICollectiveFunc ();
+	};
+	
+}
+
+
+#endif   // __ReduceLocal_BENCH_H__
@@ -15,7 +15,7 @@ SCOREP_USER_METRIC_LOCAL (bench_ReduceScatterBench_metric);
 #endif
 
 
-CMSB::ReduceScatterBench::ReduceScatterBench (unsigned int messageSize) {
+CMSB::ReduceScatterBench::ReduceScatterBench (uint64_t messageSize) {
 
     _msgSize = messageSize;
 }
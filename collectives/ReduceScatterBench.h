@@ -14,12 +14,13 @@ namespace CMSB {
 
 	public:
 
-		ReduceScatterBench  (unsigned int messageSize);
+		ReduceScatterBench  (uint64_t messageSize);
 		virtual ~ReduceScatterBench ();
 		
 		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
         virtual const char* getMicroBenchName () const;
 		virtual void writeResultToProfile () const;
+		virtual bool usesVCounts () const { return true; }
 
 	protected:
 		virtual void performMPICollectiveFunc ();
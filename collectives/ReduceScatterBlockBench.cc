@@ -0,0 +1,49 @@
+#include <mpi.h>
+#include "ReduceScatterBlockBench.h"
+
+#ifdef USE_SCOREP
+#include <scorep/SCOREP_User.h>
+#endif
+
+
+
+
+//======================================================================
+
+#ifdef USE_SCOREP
+SCOREP_USER_METRIC_LOCAL (bench_ReduceScatterBlockBench_metric);
+#endif
+
+
+CMSB::ReduceScatterBlockBench::ReduceScatterBlockBench (uint64_t messageSize) {
+
+    _msgSize = messageSize;
+}
+
+CMSB::ReduceScatterBlockBench::~ReduceScatterBlockBench () {
+}
+
+void CMSB::ReduceScatterBlockBench::init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo) {
+
+	CMSB::CollectivesBench::init (worldComm, benchInfo);
+#ifdef USE_SCOREP
+    SCOREP_USER_METRIC_INIT (bench_ReduceScatterBlockBench_metric, "ReduceScatterBlock timing", "usec",
+                             SCOREP_USER_METRIC_TYPE_DOUBLE, SCOREP_USER_METRIC_CONTEXT_GLOBAL);
+#endif
+}
+
+const char* CMSB::ReduceScatterBlockBench::getMicroBenchName () const {
+
+    return "MPI_ReduceScatterBlock";
+}
+
+void CMSB::ReduceScatterBlockBench::writeResultToProfile () const {
+
+#ifdef USE_SCOREP
+	if (_myRank == 0) {		// Only one rank should update SCORE-P's metrics
+		SCOREP_USER_METRIC_DOUBLE (bench_ReduceScatterBlockBench_metric, getMicroBenchResult ());
+	}
+#endif
+}
+
+//======================================================================
@@ -0,0 +1,31 @@
+#ifndef __ReduceScatterBlock_BENCH_H__
+#define __ReduceScatterBlock_BENCH_H__
+
+
+#include "CollectivesBench.h"
+
+
+namespace CMSB {
+
+	/**
+	 * Represents ReduceScatterBlock benchmark.
+	 */
+	class ReduceScatterBlockBench : public CMSB::CollectivesBench {
+
+	public:
+
+		ReduceScatterBlockBench  (uint64_t messageSize);
+		virtual ~ReduceScatterBlockBench ();
+		
+		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
+        virtual const char* getMicroBenchName () const;
+		virtual void writeResultToProfile () const;
+
+	protected:
+		virtual void performMPICollectiveFunc ();
+	};
+	
+}
+
+
+#endif   // __ReduceScatterBlock_BENCH_H__
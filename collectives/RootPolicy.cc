@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <cstdlib>
+#include "RootPolicy.h"
+
+
+
+CMSB::RootPolicy::RootPolicy (Type type, int param, unsigned int seed) :
+	_type			(type),
+	_param			(param),
+	_seed			(seed),
+	_numProcs		(1) {
+
+}
+
+bool CMSB::RootPolicy::parse (const std::string& str, CMSB::RootPolicy& policy) {
+
+	std::string name = str.substr (0, str.find (':'));
+	int param = (name.size () < str.size ()) ? std::atoi (str.c_str () + name.size () + 1) : 0;
+
+	if (name == "fixed" && param >= 0)			policy = RootPolicy (FIXED, param);
+	else if (name == "rotate")					policy = RootPolicy (ROTATE);
+	else if (name == "sweep")					policy = RootPolicy (SWEEP);
+	else if (name == "random" && param > 0)		policy = RootPolicy (RANDOM_SAMPLE, param);
+	else return false;
+	return true;
+}
+
+void CMSB::RootPolicy::init (int numProcs) {
+
+	_numProcs = numProcs;
+	_roots = getRoots (numProcs);
+}
+
+int CMSB::RootPolicy::getRoot (int iter) const {
+
+	switch (_type) {
+		case FIXED:
+			return _param % _numProcs;
+		case ROTATE:
+			return iter % _numProcs;
+		default:
+			return _roots[iter % _roots.size ()];
+	}
+}
+
+std::vector<int> CMSB::RootPolicy::getRoots (int numProcs) const {
+
+	std::vector<int> roots;
+
+	if (_type == FIXED) {
+		roots.push_back (_param % numProcs);
+		return roots;
+	}
+	for (int i = 0; i < numProcs; i++) roots.push_back (i);
+	if (_type == RANDOM_SAMPLE && _param < numProcs) {
+		// Partial Fisher-Yates shuffle with the Park-Miller minimal
+		// standard generator, so all ranks draw the same sample
+		unsigned int state = _seed % 2147483646U + 1;
+		for (int i = 0; i < _param; i++) {
+			state = (unsigned int)((16807ULL * state) % 2147483647U);
+			std::swap (roots[i], roots[i + state % (numProcs-i)]);
+		}
+		roots.resize (_param);
+		std::sort (roots.begin (), roots.end ());
+	}
+	return roots;
+}
+
+const char* CMSB::RootPolicy::getName () const {
+
+	switch (_type) {
+		case ROTATE:			return "rotate";
+		case SWEEP:				return "sweep";
+		case RANDOM_SAMPLE:		return "random";
+		default:				return "fixed";
+	}
+}
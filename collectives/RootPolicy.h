@@ -0,0 +1,57 @@
+#ifndef __ROOT_POLICY_H__
+#define __ROOT_POLICY_H__
+
+#include <string>
+#include <vector>
+
+
+namespace CMSB {
+
+	/**
+	 * Root of the rooted collectives. Rank 0 also does the I/O and anchors
+	 * the clock sync, so the other roots show how much the placement of
+	 * the root matters. FIXED and ROTATE are applied within one benchmark,
+	 * SWEEP and RANDOM_SAMPLE give the roots of one benchmark each.
+	 */
+	class RootPolicy {
+
+	public:
+
+		enum Type {
+			FIXED,				// Always the given root
+			ROTATE,				// Root i mod P in iteration i
+			SWEEP,				// Every rank in turn
+			RANDOM_SAMPLE		// The given number of distinct random roots
+		};
+
+		// The parameter is the root of FIXED and the sample size of
+		// RANDOM_SAMPLE
+		RootPolicy (Type type = FIXED, int param = 0, unsigned int seed = 1);
+
+		// Parses "fixed:<k>", "rotate", "sweep" or "random:<n>"
+		static bool parse (const std::string& str, CMSB::RootPolicy& policy);
+
+		// Whether the policy fits numProcs ranks - the root of FIXED has to
+		// be one of them
+		bool isValid (int numProcs) const { return _type != FIXED || _param < numProcs; }
+		// Caches the roots for numProcs ranks
+		void init (int numProcs);
+		// Root of the given iteration
+		int getRoot (int iter) const;
+		// The roots measured in turn - SWEEP and RANDOM_SAMPLE in ascending order
+		std::vector<int> getRoots (int numProcs) const;
+		Type getType () const { return _type; }
+		const char* getName () const;
+
+	protected:
+		Type			_type;
+		int				_param;
+		unsigned int	_seed;
+		int				_numProcs;
+		std::vector<int>	_roots;		// getRoots (_numProcs)
+	};
+
+}
+
+
+#endif   // __ROOT_POLICY_H__
@@ -15,7 +15,7 @@ SCOREP_USER_METRIC_LOCAL (bench_ScanBench_metric);
 #endif
 
 
-CMSB::ScanBench::ScanBench (unsigned int messageSize) {
+CMSB::ScanBench::ScanBench (uint64_t messageSize) {
 
     _msgSize = messageSize;
 }
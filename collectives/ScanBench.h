@@ -14,7 +14,7 @@ namespace CMSB {
 
 	public:
 
-		ScanBench  (unsigned int messageSize);
+		ScanBench  (uint64_t messageSize);
 		virtual ~ScanBench ();
 		
 		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
@@ -15,7 +15,7 @@ SCOREP_USER_METRIC_LOCAL (bench_ScatterBench_metric);
 #endif
 
 
-CMSB::ScatterBench::ScatterBench (unsigned int messageSize) {
+CMSB::ScatterBench::ScatterBench (uint64_t messageSize) {
 
     _msgSize = messageSize;
 }
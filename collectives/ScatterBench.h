@@ -14,7 +14,7 @@ namespace CMSB {
 
 	public:
 
-		ScatterBench  (unsigned int messageSize);
+		ScatterBench  (uint64_t messageSize);
 		virtual ~ScatterBench ();
 		
 		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
@@ -15,7 +15,7 @@ SCOREP_USER_METRIC_LOCAL (bench_ScattervBench_metric);
 #endif
 
 
-CMSB::ScattervBench::ScattervBench (unsigned int messageSize) {
+CMSB::ScattervBench::ScattervBench (uint64_t messageSize) {
 
     _msgSize = messageSize;
 }
@@ -0,0 +1,64 @@
+#ifndef __SUBCOMM_BENCHES_H__
+#define __SUBCOMM_BENCHES_H__
+
+
+#include <mpi.h>
+#include "SubcommCollectivesBench.h"
+
+
+namespace CMSB {
+
+	class SubcommAlltoallBench : public CMSB::SubcommCollectivesBench {
+	public:
+		SubcommAlltoallBench (uint64_t messageSize, int numDims, int keptDim, Mode mode,
+							  const CMSB::CollectivesBench* baseline = NULL)
+			: SubcommCollectivesBench (messageSize, numDims, keptDim, mode, baseline) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Alltoall"; }
+	protected:
+		virtual void performSubcommFunc () {
+			LARGE_COUNT_CALL (Alltoall, (_benchInfo._sendBuff, _count, _datatype, _benchInfo._recvBuff, _count, _datatype,
+										 _subComm));
+		}
+	};
+
+	class SubcommAllgatherBench : public CMSB::SubcommCollectivesBench {
+	public:
+		SubcommAllgatherBench (uint64_t messageSize, int numDims, int keptDim, Mode mode,
+							   const CMSB::CollectivesBench* baseline = NULL)
+			: SubcommCollectivesBench (messageSize, numDims, keptDim, mode, baseline) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Allgather"; }
+	protected:
+		virtual void performSubcommFunc () {
+			LARGE_COUNT_CALL (Allgather, (_benchInfo._sendBuff, _count, _datatype, _benchInfo._recvBuff, _count, _datatype,
+										  _subComm));
+		}
+	};
+
+	class SubcommAllreduceBench : public CMSB::SubcommCollectivesBench {
+	public:
+		SubcommAllreduceBench (uint64_t messageSize, int numDims, int keptDim, Mode mode,
+							   const CMSB::CollectivesBench* baseline = NULL)
+			: SubcommCollectivesBench (messageSize, numDims, keptDim, mode, baseline) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Allreduce"; }
+	protected:
+		virtual void performSubcommFunc () {
+			LARGE_COUNT_CALL (Allreduce, (_benchInfo._sendBuff, _benchInfo._recvBuff, _count, _datatype, _op, _subComm));
+		}
+	};
+
+	class SubcommBcastBench : public CMSB::SubcommCollectivesBench {
+	public:
+		SubcommBcastBench (uint64_t messageSize, int numDims, int keptDim, Mode mode,
+						   const CMSB::CollectivesBench* baseline = NULL)
+			: SubcommCollectivesBench (messageSize, numDims, keptDim, mode, baseline) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Bcast"; }
+	protected:
+		virtual void performSubcommFunc () {
+			LARGE_COUNT_CALL (Bcast, (_benchInfo._sendBuff, _count, _datatype, 0, _subComm));
+		}
+	};
+
+}
+
+
+#endif   // __SUBCOMM_BENCHES_H__
@@ -0,0 +1,137 @@
+#include <mpi.h>
+#include <iostream>
+#include <ios>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <overheads/CartcreateBench.h>
+#include <util/Statistics.h>
+#include "SubcommCollectivesBench.h"
+#include "SubcommBenches.h"
+
+
+
+CMSB::SubcommCollectivesBench::SubcommCollectivesBench (uint64_t messageSize, int numDims, int keptDim, Mode mode,
+														const CMSB::CollectivesBench* baseline) :
+	_numDims		(numDims),
+	_keptDim		(keptDim),
+	_mode			(mode),
+	_subComm		(MPI_COMM_NULL),
+	_subRank		(0),
+	_subSize		(1),
+	_subcommId		(0),
+	_active			(true) {
+
+	_msgSize = messageSize;
+	_baseline = baseline;
+}
+
+CMSB::SubcommCollectivesBench::~SubcommCollectivesBench () {
+
+	freeSubcomm ();
+}
+
+void CMSB::SubcommCollectivesBench::init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo) {
+
+	CMSB::CollectivesBench::init (worldComm, benchInfo);
+	freeSubcomm ();
+
+	// Not reordered - the grid is laid out over the ranks of worldComm
+	int periods[MAX_DIMS], remain_dims[MAX_DIMS];
+	MPI_Comm cart_comm;
+	CMSB::CartcreateBench::computeDims (_numProcs, _numDims, _dims, periods);
+	MPI_Cart_create (_worldComm, _numDims, _dims, periods, 0, &cart_comm);
+	for (int d = 0; d < _numDims; d++) remain_dims[d] = (d == _keptDim);
+	MPI_Cart_sub (cart_comm, remain_dims, &_subComm);
+	MPI_Comm_free (&cart_comm);
+
+	MPI_Comm_rank (_subComm, &_subRank);
+	MPI_Comm_size (_subComm, &_subSize);
+	_subcommId = _myRank;
+	MPI_Bcast (&_subcommId, 1, MPI_INT, 0, _subComm);
+	_active = (_mode == CONCURRENT || _subcommId == 0);
+}
+
+void CMSB::SubcommCollectivesBench::runMicroBench (CMSB::TimeSyncInfo* syncInfo) {
+
+	CMSB::CollectivesBench::runMicroBench (syncInfo);
+
+	// Every iteration of a subcommunicator takes as long as its slowest
+	// rank - the median of these per subcommunicator
+	int num_iters = _localRunTimes.size ();
+	std::vector<double> all_times ((_myRank == 0) ? _numProcs * num_iters : 0);
+	std::vector<int> all_ids ((_myRank == 0) ? _numProcs : 0);
+	MPI_Gather (&_localRunTimes[0], num_iters, MPI_DOUBLE, (_myRank == 0) ? &all_times[0] : NULL,
+				num_iters, MPI_DOUBLE, 0, _worldComm);
+	int id = _active ? _subcommId : -1;
+	MPI_Gather (&id, 1, MPI_INT, (_myRank == 0) ? &all_ids[0] : NULL, 1, MPI_INT, 0, _worldComm);
+
+	if (_myRank == 0) {
+		std::string label (getResultLabel ());
+		std::map<int, std::vector<double> > subcomm_times;
+		for (int r = 0; r < _numProcs; r++) {
+			if (all_ids[r] < 0) continue;
+			std::vector<double>& times = subcomm_times[all_ids[r]];
+			times.resize (num_iters, 0.0);
+			for (int i = 0; i < num_iters; i++) {
+				if (all_times[r*num_iters + i] > times[i]) times[i] = all_times[r*num_iters + i];
+			}
+		}
+		double sum_medians = 0.0, max_median = 0.0;
+		for (std::map<int, std::vector<double> >::iterator it = subcomm_times.begin (); it != subcomm_times.end (); ++it) {
+			double subcomm_median = median (it->second);
+			sum_medians += subcomm_median;
+			if (subcomm_median > max_median) max_median = subcomm_median;
+			std::cout << label << ": subcomm " << it->first << " median = " << std::setprecision(6)
+					  << std::fixed << subcomm_median << std::endl;
+		}
+		std::cout << label << ": subcomms = " << subcomm_times.size () << ", size = " << _subSize << std::endl;
+		std::cout << label << ": mean of subcomm medians = " << std::setprecision(6) << std::fixed
+				  << sum_medians / subcomm_times.size () << std::endl;
+		std::cout << label << ": max of subcomm medians = " << std::setprecision(6) << std::fixed
+				  << max_median << std::endl;
+	}
+}
+
+std::string CMSB::SubcommCollectivesBench::getResultLabel () const {
+
+	std::ostringstream label;
+	label << CMSB::CollectivesBench::getResultLabel () << "[cart_sub " << _numDims << "d dim " << _keptDim << "]";
+	if (_mode == SINGLE) label << "[single]";
+	return label.str ();
+}
+
+void CMSB::SubcommCollectivesBench::freeSubcomm () {
+
+	if (_subComm != MPI_COMM_NULL) {
+		MPI_Comm_free (&_subComm);
+	}
+}
+
+void CMSB::createSubcommCollectiveMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc) {
+
+	typedef CMSB::SubcommCollectivesBench Subcomm;
+
+	// Rows and columns of a 2D grid. The single run of each is the
+	// baseline of the concurrent one, so it comes first.
+	for (int d = 0; d < 2; d++) {
+		CMSB::CollectivesBench* singles[] = {
+			new CMSB::SubcommAlltoallBench	(messageSizePerProc, 2, d, Subcomm::SINGLE),
+			new CMSB::SubcommAllgatherBench	(messageSizePerProc, 2, d, Subcomm::SINGLE),
+			new CMSB::SubcommAllreduceBench	(messageSizePerProc, 2, d, Subcomm::SINGLE),
+			new CMSB::SubcommBcastBench		(messageSizePerProc, 2, d, Subcomm::SINGLE)
+		};
+		for (int j = 0; j < 4; j++) benchmarks.push_back (singles[j]);
+		benchmarks.push_back (new CMSB::SubcommAlltoallBench	(messageSizePerProc, 2, d, Subcomm::CONCURRENT, singles[0]));
+		benchmarks.push_back (new CMSB::SubcommAllgatherBench	(messageSizePerProc, 2, d, Subcomm::CONCURRENT, singles[1]));
+		benchmarks.push_back (new CMSB::SubcommAllreduceBench	(messageSizePerProc, 2, d, Subcomm::CONCURRENT, singles[2]));
+		benchmarks.push_back (new CMSB::SubcommBcastBench		(messageSizePerProc, 2, d, Subcomm::CONCURRENT, singles[3]));
+	}
+
+	// The pencils of a 3D grid, as in the transposes of a 3D FFT
+	for (int d = 0; d < 3; d++) {
+		CMSB::CollectivesBench* single = new CMSB::SubcommAlltoallBench (messageSizePerProc, 3, d, Subcomm::SINGLE);
+		benchmarks.push_back (single);
+		benchmarks.push_back (new CMSB::SubcommAlltoallBench (messageSizePerProc, 3, d, Subcomm::CONCURRENT, single));
+	}
+}
@@ -0,0 +1,65 @@
+#ifndef __SUBCOMM_COLLECTIVES_BENCH_H__
+#define __SUBCOMM_COLLECTIVES_BENCH_H__
+
+
+#include <mpi.h>
+#include <string>
+#include <vector>
+#include "CollectivesBench.h"
+
+
+namespace CMSB {
+
+	/**
+	 * Base class for collectives that run on all subcommunicators of a
+	 * grid at the same time, like the row and column transposes of FFT
+	 * and 2D-decomposition codes. The ranks form the grid of
+	 * CartcreateBench, MPI_Cart_sub keeps one of its dimensions. All
+	 * subcommunicators start in the same sync window, the result is the
+	 * slowest of them. In the single mode only the subcommunicator of
+	 * rank 0 runs, which is the baseline without the contention of the
+	 * others.
+	 */
+	class SubcommCollectivesBench : public CMSB::CollectivesBench {
+
+	public:
+
+		enum Mode {
+			CONCURRENT,
+			SINGLE
+		};
+
+		static const int MAX_DIMS = 3;
+
+		// The baseline is not owned, it has to run before this benchmark
+		SubcommCollectivesBench  (uint64_t messageSize, int numDims, int keptDim, Mode mode,
+								  const CMSB::CollectivesBench* baseline = NULL);
+		virtual ~SubcommCollectivesBench ();
+
+		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
+		virtual void runMicroBench (CMSB::TimeSyncInfo* syncInfo);
+		virtual void writeResultToProfile () const { }
+		virtual unsigned int getMemConsumption () const { return sizeof (CMSB::SubcommCollectivesBench); }
+
+	protected:
+		virtual void performMPICollectiveFunc () { if (_active) performSubcommFunc (); }
+		virtual void performSubcommFunc () = 0;
+		virtual std::string getResultLabel () const;
+		void freeSubcomm ();
+
+		int				_numDims;
+		int				_keptDim;
+		Mode			_mode;
+		int				_dims[MAX_DIMS];
+		MPI_Comm		_subComm;
+		int				_subRank;
+		int				_subSize;
+		int				_subcommId;		// World rank of the first rank of the subcommunicator
+		bool			_active;
+	};
+
+	void createSubcommCollectiveMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc);
+}
+
+
+#endif   // __SUBCOMM_COLLECTIVES_BENCH_H__
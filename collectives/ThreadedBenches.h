@@ -0,0 +1,69 @@
+#ifndef __THREADED_BENCHES_H__
+#define __THREADED_BENCHES_H__
+
+
+#include <mpi.h>
+#include "ThreadedCollectivesBench.h"
+
+
+namespace CMSB {
+
+	class ThreadedAllreduceBench : public CMSB::ThreadedCollectivesBench {
+	public:
+		ThreadedAllreduceBench (uint64_t messageSize, int numThreads, const CMSB::CollectivesBench* baseline = NULL)
+			: ThreadedCollectivesBench (messageSize, numThreads, baseline) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Allreduce"; }
+	protected:
+		virtual void performThreadFunc (MPI_Comm comm, double* sendBuff, double* recvBuff) {
+			LARGE_COUNT_CALL (Allreduce, (sendBuff, recvBuff, _count, _datatype, _op, comm));
+		}
+	};
+
+	class ThreadedAlltoallBench : public CMSB::ThreadedCollectivesBench {
+	public:
+		ThreadedAlltoallBench (uint64_t messageSize, int numThreads, const CMSB::CollectivesBench* baseline = NULL)
+			: ThreadedCollectivesBench (messageSize, numThreads, baseline) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Alltoall"; }
+	protected:
+		virtual void performThreadFunc (MPI_Comm comm, double* sendBuff, double* recvBuff) {
+			LARGE_COUNT_CALL (Alltoall, (sendBuff, _count, _datatype, recvBuff, _count, _datatype, comm));
+		}
+	};
+
+	class ThreadedAllgatherBench : public CMSB::ThreadedCollectivesBench {
+	public:
+		ThreadedAllgatherBench (uint64_t messageSize, int numThreads, const CMSB::CollectivesBench* baseline = NULL)
+			: ThreadedCollectivesBench (messageSize, numThreads, baseline) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Allgather"; }
+	protected:
+		virtual void performThreadFunc (MPI_Comm comm, double* sendBuff, double* recvBuff) {
+			LARGE_COUNT_CALL (Allgather, (sendBuff, _count, _datatype, recvBuff, _count, _datatype, comm));
+		}
+	};
+
+	class ThreadedBcastBench : public CMSB::ThreadedCollectivesBench {
+	public:
+		ThreadedBcastBench (uint64_t messageSize, int numThreads, const CMSB::CollectivesBench* baseline = NULL)
+			: ThreadedCollectivesBench (messageSize, numThreads, baseline) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Bcast"; }
+	protected:
+		virtual void performThreadFunc (MPI_Comm comm, double* sendBuff, double*) {
+			LARGE_COUNT_CALL (Bcast, (sendBuff, _count, _datatype, 0, comm));
+		}
+	};
+
+	class ThreadedBarrierBench : public CMSB::ThreadedCollectivesBench {
+	public:
+		ThreadedBarrierBench (int numThreads, const CMSB::CollectivesBench* baseline = NULL)
+			: ThreadedCollectivesBench (0, numThreads, baseline) {}
+		virtual const char* getMicroBenchName () const { return "MPI_Barrier"; }
+	protected:
+		virtual void performThreadFunc (MPI_Comm comm, double*, double*) {
+			MPI_Barrier (comm);
+		}
+	};
+
+}
+
+
+#endif   // __THREADED_BENCHES_H__
@@ -0,0 +1,175 @@
+#include <mpi.h>
+#include <iostream>
+#include <ios>
+#include <iomanip>
+#include <sstream>
+#include <timing/elg_pform_defs.h>
+#include <util/Statistics.h>
+#include "ThreadedCollectivesBench.h"
+#include "ThreadedBenches.h"
+
+
+
+CMSB::ThreadedCollectivesBench::ThreadedCollectivesBench (uint64_t messageSize, int numThreads,
+														  const CMSB::CollectivesBench* baseline) :
+	_numThreads		(numThreads) {
+
+	_msgSize = messageSize;
+	_baseline = baseline;
+}
+
+CMSB::ThreadedCollectivesBench::~ThreadedCollectivesBench () {
+
+	_team.stop ();
+	freeThreadComms ();
+}
+
+void CMSB::ThreadedCollectivesBench::init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo) {
+
+	CMSB::CollectivesBench::init (worldComm, benchInfo);
+	freeThreadComms ();
+
+	// Thread 0 uses the shared buffers, the others get the same amount
+	// of their own - enough for a block from every rank
+	MPI_Aint lb, extent;
+	MPI_Type_get_extent (_datatype, &lb, &extent);
+	uint64_t buff_len = (uint64_t)_count * extent * _numProcs / sizeof (double) + 1;
+	_threadComms.resize (_numThreads);
+	_threadSendBuffs.resize (_numThreads);
+	_threadRecvBuffs.resize (_numThreads);
+	_roundTimes.assign (_numThreads, std::vector<double> (NUM_ITERS_ROUND, 0.0));
+	_threadTimes.assign (_numThreads, std::vector<double> ());
+	for (int t = 0; t < _numThreads; t++) {
+		MPI_Comm_dup (_worldComm, &_threadComms[t]);
+		if (t > 0) {
+			_threadSendBuffs[t].assign (buff_len, _myRank+1);
+			_threadRecvBuffs[t].assign (buff_len, 0.0);
+		}
+		_threadTimes[t].reserve (NUM_ITERS_TOTAL);
+	}
+}
+
+void CMSB::ThreadedCollectivesBench::runMicroBench (CMSB::TimeSyncInfo* syncInfo) {
+
+	for (int t = 0; t < _numThreads; t++) _threadTimes[t].clear ();
+	_team.start (_numThreads, performThreadCall, this);
+	CMSB::CollectivesBench::runMicroBench (syncInfo);
+	_team.stop ();
+
+	// Every thread times its own calls - the median of the slowest rank
+	// of each thread
+	std::vector<double> thread_medians (_numThreads, 0.0), max_thread_medians (_numThreads, 0.0);
+	for (int t = 0; t < _numThreads; t++) {
+		if (!_threadTimes[t].empty ()) thread_medians[t] = median (_threadTimes[t]);
+	}
+	MPI_Reduce (&thread_medians[0], &max_thread_medians[0], _numThreads, MPI_DOUBLE, MPI_MAX, 0, _worldComm);
+
+	if (_myRank == 0) {
+		std::string label (getResultLabel ());
+		for (int t = 0; t < _numThreads; t++) {
+			std::cout << label << ": thread " << t << " median = " << std::setprecision(6)
+					  << std::fixed << max_thread_medians[t] << std::endl;
+		}
+		// An iteration completes one call on every thread
+		std::cout << label << ": aggregate rate (calls/s) = " << std::setprecision(6) << std::fixed
+				  << _numThreads * 1e6 / _avgRunTime << std::endl;
+		std::cout << label << ": aggregate bandwidth (MB/s) = " << std::setprecision(6) << std::fixed
+				  << _numThreads * _msgSize * sizeof (double) / _avgRunTime << std::endl;
+		if (_baseline != NULL) {
+			// Below the thread count where the threads contend in the library
+			std::cout << label << ": aggregate rate over one thread = "
+					  << std::setprecision(6) << std::fixed
+					  << _numThreads * _baseline->getMicroBenchResult () / _avgRunTime << std::endl;
+		}
+	}
+}
+
+unsigned int CMSB::ThreadedCollectivesBench::getMemConsumption () const {
+
+	unsigned int mem = sizeof (CMSB::ThreadedCollectivesBench);
+	for (size_t t = 0; t < _threadComms.size (); t++) {
+		mem += (_threadSendBuffs[t].capacity () + _threadRecvBuffs[t].capacity ()
+				+ _roundTimes[t].capacity () + _threadTimes[t].capacity ()) * sizeof (double);
+	}
+	return mem;
+}
+
+void CMSB::ThreadedCollectivesBench::performMPICollectiveFunc () {
+
+	_team.run ();
+}
+
+std::string CMSB::ThreadedCollectivesBench::getResultLabel () const {
+
+	std::ostringstream label;
+	label << CMSB::CollectivesBench::getResultLabel () << "[threads " << _numThreads << "]";
+	return label.str ();
+}
+
+void CMSB::ThreadedCollectivesBench::performThreadCall (void* bench, int thread) {
+
+	CMSB::ThreadedCollectivesBench* self = (CMSB::ThreadedCollectivesBench*)bench;
+	double* send_buff = (thread > 0) ? &self->_threadSendBuffs[thread][0] : self->_benchInfo._sendBuff;
+	double* recv_buff = (thread > 0) ? &self->_threadRecvBuffs[thread][0] : self->_benchInfo._recvBuff;
+	double start_time = CMSB::elg_pform_wtime ();
+	self->performThreadFunc (self->_threadComms[thread], send_buff, recv_buff);
+	double end_time = CMSB::elg_pform_wtime ();
+	// Set by the main thread before it releases the others
+	if (self->_roundIter >= 0) {
+		self->_roundTimes[thread][self->_roundIter] = (end_time - start_time) * 1e6;	// Convert to usec
+	}
+}
+
+void CMSB::ThreadedCollectivesBench::keepIterations (const int* iters, int numIters) {
+
+	for (int t = 0; t < _numThreads; t++) {
+		for (int i = 0; i < numIters; i++) {
+			_threadTimes[t].push_back (_roundTimes[t][iters[i]]);
+		}
+	}
+}
+
+void CMSB::ThreadedCollectivesBench::freeThreadComms () {
+
+	for (size_t t = 0; t < _threadComms.size (); t++) {
+		MPI_Comm_free (&_threadComms[t]);
+	}
+	_threadComms.clear ();
+}
+
+void CMSB::createThreadedCollectiveMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc,
+												 int numThreads) {
+
+	// More than one thread needs the full thread support
+	int provided = MPI_THREAD_SINGLE;
+	MPI_Query_thread (&provided);
+	if (provided < MPI_THREAD_MULTIPLE) {
+		int my_rank;
+		MPI_Comm_rank (MPI_COMM_WORLD, &my_rank);
+		if (my_rank == 0) {
+			std::cout << "Threaded collectives: warning: MPI_THREAD_MULTIPLE is not provided,"
+					  << " running one thread only" << std::endl;
+		}
+		numThreads = 1;
+	}
+
+	// The single thread of each collective is the baseline, so it runs first
+	CMSB::CollectivesBench* allreduce = new CMSB::ThreadedAllreduceBench (messageSizePerProc, 1);
+	CMSB::CollectivesBench* alltoall = new CMSB::ThreadedAlltoallBench (messageSizePerProc, 1);
+	CMSB::CollectivesBench* allgather = new CMSB::ThreadedAllgatherBench (messageSizePerProc, 1);
+	CMSB::CollectivesBench* bcast = new CMSB::ThreadedBcastBench (messageSizePerProc, 1);
+	CMSB::CollectivesBench* barrier = new CMSB::ThreadedBarrierBench (1);
+	benchmarks.push_back (allreduce);
+	benchmarks.push_back (alltoall);
+	benchmarks.push_back (allgather);
+	benchmarks.push_back (bcast);
+	benchmarks.push_back (barrier);
+
+	for (int t = 2; t <= numThreads; t = (t < numThreads && 2*t > numThreads) ? numThreads : 2*t) {
+		benchmarks.push_back (new CMSB::ThreadedAllreduceBench	(messageSizePerProc, t, allreduce));
+		benchmarks.push_back (new CMSB::ThreadedAlltoallBench	(messageSizePerProc, t, alltoall));
+		benchmarks.push_back (new CMSB::ThreadedAllgatherBench	(messageSizePerProc, t, allgather));
+		benchmarks.push_back (new CMSB::ThreadedBcastBench		(messageSizePerProc, t, bcast));
+		benchmarks.push_back (new CMSB::ThreadedBarrierBench	(t, barrier));
+	}
+}
@@ -0,0 +1,66 @@
+#ifndef __THREADED_COLLECTIVES_BENCH_H__
+#define __THREADED_COLLECTIVES_BENCH_H__
+
+
+#include <mpi.h>
+#include <string>
+#include <vector>
+#include <util/ThreadTeam.h>
+#include "CollectivesBench.h"
+
+
+namespace CMSB {
+
+	/**
+	 * Base class for collectives that several threads of every rank call
+	 * at the same time, as in hybrid codes - needs MPI_THREAD_MULTIPLE.
+	 * Each thread has its own duplicate of the world communicator and its
+	 * own buffers. The main thread is thread 0, it syncs and releases the
+	 * others into the collective, an iteration ends when all of them
+	 * returned. With one thread this is the baseline without contention
+	 * on the locks of the MPI library.
+	 */
+	class ThreadedCollectivesBench : public CMSB::CollectivesBench {
+
+	public:
+
+		// The baseline is not owned, it has to run before this benchmark
+		ThreadedCollectivesBench  (uint64_t messageSize, int numThreads,
+								   const CMSB::CollectivesBench* baseline = NULL);
+		virtual ~ThreadedCollectivesBench ();
+
+		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
+		virtual void runMicroBench (CMSB::TimeSyncInfo* syncInfo);
+		virtual void writeResultToProfile () const { }
+		virtual unsigned int getMemConsumption () const;
+
+	protected:
+		virtual void performMPICollectiveFunc ();
+		// The collective of one thread on its communicator and buffers
+		virtual void performThreadFunc (MPI_Comm comm, double* sendBuff, double* recvBuff) = 0;
+		virtual void keepIterations (const int* iters, int numIters);
+		virtual std::string getResultLabel () const;
+
+		int				_numThreads;
+
+	private:
+		static void performThreadCall (void* bench, int thread);
+		void freeThreadComms ();
+
+		std::vector<MPI_Comm>				_threadComms;
+		std::vector<std::vector<double> >	_threadSendBuffs;
+		std::vector<std::vector<double> >	_threadRecvBuffs;
+		// Times of the calls of every thread in the current round, and
+		// of those in the valid iterations
+		std::vector<std::vector<double> >	_roundTimes;
+		std::vector<std::vector<double> >	_threadTimes;
+		CMSB::ThreadTeam					_team;
+	};
+
+	// Thread counts are the powers of two up to numThreads, and numThreads
+	void createThreadedCollectiveMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc,
+											   int numThreads);
+}
+
+
+#endif   // __THREADED_COLLECTIVES_BENCH_H__
@@ -8,12 +8,22 @@ my $collecs_MPI_func = "";
 if (open (MYIN_FILE, "<", $collecs_file)) {
 	while (my $collec = <MYIN_FILE>) {
 		chomp $collec;
+		# A collective is followed by its flags - vcounts for the ones
+		# taking count and displacement arrays, local for the local
+		# reduction
+		my @flags;
+		($collec, @flags) = split (' ', $collec);
+		my $vcounts = grep { $_ eq "vcounts" } @flags;
+		my $local = grep { $_ eq "local" } @flags;
 		
 		my $out_hdr_file = "${collec}Bench.h";
 		open (MYOUT_HDR_FILE, ">", $out_hdr_file);
 		
 		open (TMPL_INPUT, "<", "hdr.in");
 		while (<TMPL_INPUT>) {
+			next if (!$vcounts && /^#VCOUNTS#/);
+			next if (!$local && /^#LOCAL#/);
+			s/^#(VCOUNTS|LOCAL)#//;
 			s/#COLLEC#/$collec/gi;
 			print MYOUT_HDR_FILE $_;
 		}
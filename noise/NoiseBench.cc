@@ -0,0 +1,329 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <ios>
+#include <iomanip>
+#include <map>
+#include <timing/elg_pform_defs.h>
+#include <collectives/CollectivesBench.h>
+#include "NoiseBench.h"
+
+
+#define MAX_DOUBLE 1e99
+
+
+// Noise of the ranks of one node
+struct NodeNoise {
+	NodeNoise () : numRanks (0), fraction (0.0), maxDetour (0.0), stragglers (0.0) {
+		for (int i = 0; i < CMSB::NoiseBench::NUM_HIST_BINS; i++) hist[i] = 0.0;
+	}
+	int numRanks;
+	double fraction;
+	double maxDetour;
+	double stragglers;
+	double hist[CMSB::NoiseBench::NUM_HIST_BINS];
+};
+
+
+// Correlation coefficient of two series - 0 if one of them is constant
+static double pearson (const std::vector<double>& x, const std::vector<double>& y) {
+
+	double n = x.size (), sx = 0, sy = 0, sxx = 0, syy = 0, sxy = 0;
+	for (unsigned int i = 0; i < x.size (); i++) {
+		sx += x[i];
+		sy += y[i];
+		sxx += x[i]*x[i];
+		syy += y[i]*y[i];
+		sxy += x[i]*y[i];
+	}
+	double vx = n*sxx - sx*sx;
+	double vy = n*syy - sy*sy;
+	if (vx <= 0.0 || vy <= 0.0) return 0.0;
+	return (n*sxy - sx*sy) / std::sqrt (vx*vy);
+}
+
+
+CMSB::NoiseBench::NoiseBench ()
+	: _myRank (0), _numProcs (0), _node (0), _nodeComm (MPI_COMM_NULL), _syncFailed (false),
+	  _fwqUnits (1), _ftqUnits (1), _maxNoiseFraction (0.0) {
+}
+
+
+CMSB::NoiseBench::~NoiseBench () {
+
+	if (_nodeComm != MPI_COMM_NULL) {
+		MPI_Comm_free (&_nodeComm);
+	}
+}
+
+
+void CMSB::NoiseBench::init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo) {
+
+	CMSB::MicroBench::init (worldComm, benchInfo);
+
+	MPI_Comm_rank (_worldComm, &_myRank);
+	MPI_Comm_size (_worldComm, &_numProcs);
+
+	// Ranks of a node are named after the rank of their leader
+	if (_nodeComm != MPI_COMM_NULL) {
+		MPI_Comm_free (&_nodeComm);
+	}
+#if MPI_VERSION >= 3
+	MPI_Comm_split_type (_worldComm, MPI_COMM_TYPE_SHARED, _myRank, MPI_INFO_NULL, &_nodeComm);
+#else
+	MPI_Comm_split (_worldComm, _myRank, 0, &_nodeComm);
+#endif
+	_node = _myRank;
+	MPI_Bcast (&_node, 1, MPI_INT, 0, _nodeComm);
+
+	_fwqUnits = _kernel.calibrate (QUANTUM_USEC * 1e-6);
+	_ftqUnits = _kernel.calibrate (FTQ_UNIT_USEC * 1e-6);
+}
+
+
+void CMSB::NoiseBench::runMicroBench (CMSB::TimeSyncInfo* syncInfo) {
+
+	double result[RES_LEN];
+	std::vector<double> results (_numProcs * RES_LEN);
+
+	// Both modes start at the same time on all ranks - a rank that starts
+	// late sees the others' series as noise. The window is sized for the
+	// whole series and doubled after a failed start, the collectives get
+	// their own one back.
+	double window = syncInfo->_window;
+	syncInfo->_esttime = NUM_QUANTA * QUANTUM_USEC * 1.2;
+	_syncFailed = true;
+	for (int attempt = 0; attempt < MAX_SYNC_ATTEMPTS && _syncFailed; attempt++) {
+		runSeries (syncInfo, result);
+		if (_syncFailed) syncInfo->_window *= 2.0;
+	}
+	syncInfo->_window = window;
+
+	// The spectrum of a node is the one of the mean detour series of its
+	// ranks - noise they share adds up there, noise of single ranks not
+	int node_rank, node_size;
+	MPI_Comm_rank (_nodeComm, &node_rank);
+	MPI_Comm_size (_nodeComm, &node_size);
+	std::vector<double> node_detours (NUM_QUANTA);
+	MPI_Reduce (_samples, &node_detours[0], NUM_QUANTA, MPI_DOUBLE, MPI_SUM, 0, _nodeComm);
+	if (node_rank == 0) {
+		for (int i = 0; i < NUM_QUANTA; i++) node_detours[i] /= node_size;
+		findPeaks (&node_detours[0], result + RES_NODE_PEAK_FREQ, result + RES_NODE_PEAK_AMP);
+	}
+
+	MPI_Gather (result, RES_LEN, MPI_DOUBLE, &results[0], RES_LEN, MPI_DOUBLE, 0, _worldComm);
+	if (_myRank == 0) {
+		printReport (results);
+	}
+}
+
+
+// One synchronized FWQ and FTQ series - _syncFailed tells if a sync
+// failed on any rank. _samples keeps the FTQ detours.
+void CMSB::NoiseBench::runSeries (CMSB::TimeSyncInfo* syncInfo, double* result) {
+
+	for (int i = 0; i < RES_LEN; i++) result[i] = 0.0;
+	result[RES_NODE] = _node;
+	int world_rank;
+	MPI_Comm_rank (MPI_COMM_WORLD, &world_rank);
+	result[RES_WORLD_RANK] = world_rank;
+
+	// The first start time follows the bcast of sync_init_stage2 right
+	// away and is often missed - the series start one window later
+	CMSB::sync_init_stage2 (syncInfo);
+	CMSB::nbcb_sync (syncInfo);
+	double fwq_err = CMSB::nbcb_sync (syncInfo);
+	double fwq_enter = syncInfo->_syncEnter, fwq_start = syncInfo->_syncStart;
+	runFWQ (result);
+	double ftq_err = CMSB::nbcb_sync (syncInfo);
+	runFTQ (result);
+	CMSB::sync_trace (syncInfo, fwq_enter, fwq_start, fwq_err);
+	CMSB::sync_trace (syncInfo, syncInfo->_syncEnter, syncInfo->_syncStart, ftq_err);
+
+	int failed = (fwq_err > 0.0 || ftq_err > 0.0), any_failed;
+	MPI_Allreduce (&failed, &any_failed, 1, MPI_INT, MPI_MAX, _worldComm);
+	CMSB::sync_report_errors (syncInfo, any_failed, 1);
+	_syncFailed = (any_failed != 0);
+}
+
+
+void CMSB::NoiseBench::runFWQ (double* result) {
+
+	double min_time = MAX_DOUBLE, sum = 0.0, lost = 0.0, max_detour = 0.0;
+
+	for (int i = 0; i < NUM_QUANTA; i++) {
+		double start_time = CMSB::elg_pform_wtime ();
+		_kernel.run (_fwqUnits);
+		_samples[i] = CMSB::elg_pform_wtime () - start_time;
+	}
+
+	for (int i = 0; i < NUM_QUANTA; i++) {
+		if (_samples[i] < min_time) min_time = _samples[i];
+		sum += _samples[i];
+	}
+	for (int i = 0; i < NUM_QUANTA; i++) {
+		double detour = (_samples[i] - min_time) * 1e6;    // Convert to usec
+		int bin = (detour < 1.0) ? 0 : 1 + (int)std::floor (std::log (detour) / std::log (2.0));
+		if (bin >= NUM_HIST_BINS) bin = NUM_HIST_BINS-1;
+		result[RES_HIST + bin] += 1.0;
+		lost += detour;
+		if (detour > max_detour) max_detour = detour;
+	}
+	result[RES_FWQ_FRACTION] = lost / (sum * 1e6);
+	result[RES_FWQ_MAX_DETOUR] = max_detour;
+}
+
+
+void CMSB::NoiseBench::runFTQ (double* result) {
+
+	double quantum = QUANTUM_USEC * 1e-6;
+	double start_time = CMSB::elg_pform_wtime ();
+	double max_count = 0.0, lost = 0.0, max_detour = 0.0;
+
+	// The slots are aligned to the start, a long detour leaves empty slots
+	for (int i = 0; i < NUM_QUANTA; i++) {
+		double end_time = start_time + (i+1) * quantum;
+		unsigned int count = 0;
+		while (CMSB::elg_pform_wtime () < end_time) {
+			_kernel.run (_ftqUnits);
+			count++;
+		}
+		_samples[i] = count;
+	}
+
+	for (int i = 0; i < NUM_QUANTA; i++) {
+		if (_samples[i] > max_count) max_count = _samples[i];
+	}
+	for (int i = 0; i < NUM_QUANTA; i++) {
+		_samples[i] = (max_count - _samples[i]) / max_count * QUANTUM_USEC;
+		lost += _samples[i];
+		if (_samples[i] > max_detour) max_detour = _samples[i];
+	}
+	result[RES_FTQ_FRACTION] = lost / (NUM_QUANTA * QUANTUM_USEC);
+	result[RES_FTQ_MAX_DETOUR] = max_detour;
+
+	findPeaks (_samples, result + RES_PEAK_FREQ, result + RES_PEAK_AMP);
+}
+
+
+void CMSB::NoiseBench::findPeaks (const double* detours, double* freqs, double* amps) {
+
+	const double pi = 3.14159265358979323846;
+	double mean = 0.0;
+
+	for (int i = 0; i < NUM_QUANTA; i++) mean += detours[i];
+	mean /= NUM_QUANTA;
+
+	// Amplitude spectrum of the detour series, keep the strongest lines
+	for (int k = 1; k <= NUM_QUANTA/2; k++) {
+		double re = 0.0, im = 0.0;
+		for (int i = 0; i < NUM_QUANTA; i++) {
+			double phase = 2.0 * pi * k * i / NUM_QUANTA;
+			re += (detours[i] - mean) * std::cos (phase);
+			im -= (detours[i] - mean) * std::sin (phase);
+		}
+		double amp = 2.0 * std::sqrt (re*re + im*im) / NUM_QUANTA;
+		for (int p = 0; p < NUM_PEAKS; p++) {
+			if (amp > amps[p]) {
+				for (int q = NUM_PEAKS-1; q > p; q--) {
+					amps[q] = amps[q-1];
+					freqs[q] = freqs[q-1];
+				}
+				amps[p] = amp;
+				freqs[p] = k / (NUM_QUANTA * QUANTUM_USEC * 1e-6);
+				break;
+			}
+		}
+	}
+}
+
+
+void CMSB::NoiseBench::printReport (const std::vector<double>& results) {
+
+	if (_syncFailed) {
+		std::cout << getMicroBenchName () << ": warning: the series did not start in sync on all ranks after "
+				  << MAX_SYNC_ATTEMPTS << " attempts" << std::endl;
+	}
+
+	std::map<int, NodeNoise> nodes;
+	const std::vector<int>& straggler_counts = CMSB::CollectivesBench::getStragglerCounts ();
+	std::vector<double> rank_noise (_numProcs), rank_stragglers (_numProcs, 0.0);
+
+	_maxNoiseFraction = 0.0;
+	for (int r = 0; r < _numProcs; r++) {
+		const double* res = &results[r * RES_LEN];
+		NodeNoise& node = nodes[(int)res[RES_NODE]];
+
+		rank_noise[r] = res[RES_FWQ_FRACTION];
+		int world_rank = (int)res[RES_WORLD_RANK];
+		if (world_rank < (int)straggler_counts.size ()) rank_stragglers[r] = straggler_counts[world_rank];
+		if (res[RES_FWQ_FRACTION] > _maxNoiseFraction) _maxNoiseFraction = res[RES_FWQ_FRACTION];
+
+		std::cout << getMicroBenchName () << ": rank " << r << ", node " << (int)res[RES_NODE]
+				  << ": fwq noise = " << std::setprecision(6) << std::fixed << res[RES_FWQ_FRACTION]
+				  << ", fwq max detour = " << std::setprecision(6) << std::fixed << res[RES_FWQ_MAX_DETOUR]
+				  << ", ftq noise = " << std::setprecision(6) << std::fixed << res[RES_FTQ_FRACTION]
+				  << ", ftq max detour = " << std::setprecision(6) << std::fixed << res[RES_FTQ_MAX_DETOUR]
+				  << ", stragglers = " << (int)rank_stragglers[r] << std::endl;
+		std::cout << getMicroBenchName () << ": rank " << r << ": peaks (Hz, usec) =";
+		for (int p = 0; p < NUM_PEAKS; p++) {
+			std::cout << " " << std::setprecision(1) << std::fixed << res[RES_PEAK_FREQ + p]
+					  << " " << std::setprecision(6) << std::fixed << res[RES_PEAK_AMP + p];
+		}
+		std::cout << std::endl;
+		std::cout << getMicroBenchName () << ": rank " << r << ": detour histogram =";
+		for (int b = 0; b < NUM_HIST_BINS; b++) {
+			std::cout << " " << (int)res[RES_HIST + b];
+			node.hist[b] += res[RES_HIST + b];
+		}
+		std::cout << std::endl;
+
+		node.numRanks++;
+		node.fraction += res[RES_FWQ_FRACTION];
+		node.maxDetour = std::max (node.maxDetour, res[RES_FWQ_MAX_DETOUR]);
+		node.stragglers += rank_stragglers[r];
+	}
+
+	std::vector<double> node_noise, node_stragglers;
+	for (std::map<int, NodeNoise>::iterator it = nodes.begin (); it != nodes.end (); ++it) {
+		NodeNoise& node = it->second;
+		node.fraction /= node.numRanks;
+		node_noise.push_back (node.fraction);
+		node_stragglers.push_back (node.stragglers);
+
+		std::cout << getMicroBenchName () << ": node " << it->first << ", ranks = " << node.numRanks
+				  << ": fwq noise = " << std::setprecision(6) << std::fixed << node.fraction
+				  << ", fwq max detour = " << std::setprecision(6) << std::fixed << node.maxDetour
+				  << ", stragglers = " << (int)node.stragglers << std::endl;
+		std::cout << getMicroBenchName () << ": node " << it->first << ": detour histogram =";
+		for (int b = 0; b < NUM_HIST_BINS; b++) {
+			std::cout << " " << (int)node.hist[b];
+		}
+		std::cout << std::endl;
+		const double* leader_res = &results[it->first * RES_LEN];
+		std::cout << getMicroBenchName () << ": node " << it->first << ": peaks (Hz, usec) =";
+		for (int p = 0; p < NUM_PEAKS; p++) {
+			std::cout << " " << std::setprecision(1) << std::fixed << leader_res[RES_NODE_PEAK_FREQ + p]
+					  << " " << std::setprecision(6) << std::fixed << leader_res[RES_NODE_PEAK_AMP + p];
+		}
+		std::cout << std::endl;
+	}
+
+	// Noisy ranks should be the late ones in the collective outliers
+	int num_outliers = CMSB::CollectivesBench::getNumOutliers ();
+	std::cout << getMicroBenchName () << ": collective outliers = " << num_outliers << std::endl;
+	if (num_outliers > 0) {
+		std::cout << getMicroBenchName () << ": correlation of noise and stragglers: rank = "
+				  << std::setprecision(6) << std::fixed << pearson (rank_noise, rank_stragglers)
+				  << ", node = " << std::setprecision(6) << std::fixed << pearson (node_noise, node_stragglers)
+				  << std::endl;
+	}
+	std::cout << getMicroBenchName () << ": max noise = " << std::setprecision(6)
+			  << std::fixed << _maxNoiseFraction << std::endl;
+}
+
+
+void CMSB::createNoiseMicroBenches (std::vector<MicroBench*>& benchmarks) {
+
+	benchmarks.push_back (new CMSB::NoiseBench ());
+}
@@ -0,0 +1,94 @@
+#ifndef __NOISE_BENCH_H__
+#define __NOISE_BENCH_H__
+
+
+#include <mpi.h>
+#include <vector>
+#include <MicroBench.h>
+#include <util/ComputeKernel.h>
+
+
+namespace CMSB {
+
+	/**
+	 * Measures the OS noise of every rank at the same time. Fixed work
+	 * quantum (FWQ): a calibrated piece of work is timed repeatedly, the
+	 * excess over the fastest run is the detour. Fixed time quantum (FTQ):
+	 * the work done in aligned slots of fixed length is counted, the
+	 * missing work is the detour and the count series gives the frequency
+	 * of periodic noise. Both start at a synchronized point in time.
+	 * Rank 0 reports the noise per rank and per node (with the spectrum of
+	 * the mean detour series of the node) and correlates it with
+	 * the ranks that were late in the collective outliers of this job.
+	 */
+	class NoiseBench : public CMSB::MicroBench {
+	public:
+
+		// Number of quanta per mode
+		static const int NUM_QUANTA = 1000;
+
+		// Length of a quantum in usec
+		static const int QUANTUM_USEC = 100;
+
+		// FTQ counts work units of about this many usec
+		static const int FTQ_UNIT_USEC = 1;
+
+		// Detours are binned by powers of two in usec, the last bin is open
+		static const int NUM_HIST_BINS = 12;
+
+		// Number of FTQ frequency peaks reported per rank and node
+		static const int NUM_PEAKS = 3;
+
+		// Runs of the series until both modes started in sync on all
+		// ranks - the window doubles after every failed one
+		static const int MAX_SYNC_ATTEMPTS = 4;
+
+		NoiseBench ();
+		virtual ~NoiseBench ();
+
+		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
+		virtual void runMicroBench (CMSB::TimeSyncInfo* syncInfo);
+		virtual const char* getMicroBenchName  () const { return "OSNoise"; }
+		virtual double getMicroBenchResult     () const { return _maxNoiseFraction; }
+		virtual void writeResultToProfile      () const { }
+		virtual unsigned int getMemConsumption () const { return sizeof (CMSB::NoiseBench); }
+
+	protected:
+		// Per-rank results as sent to rank 0
+		enum ResultField {
+			RES_NODE,               // Rank of the node leader
+			RES_WORLD_RANK,         // Rank in MPI_COMM_WORLD - the key of the straggler counts
+			RES_FWQ_FRACTION,       // Share of the time lost to detours
+			RES_FWQ_MAX_DETOUR,     // In usec
+			RES_FTQ_FRACTION,
+			RES_FTQ_MAX_DETOUR,     // In usec
+			RES_PEAK_FREQ,          // NUM_PEAKS frequencies in Hz
+			RES_PEAK_AMP = RES_PEAK_FREQ + NUM_PEAKS,      // In usec
+			RES_HIST = RES_PEAK_AMP + NUM_PEAKS,           // NUM_HIST_BINS detour counts
+			RES_NODE_PEAK_FREQ = RES_HIST + NUM_HIST_BINS,  // Peaks of the node - only on its leader
+			RES_NODE_PEAK_AMP = RES_NODE_PEAK_FREQ + NUM_PEAKS,
+			RES_LEN = RES_NODE_PEAK_AMP + NUM_PEAKS
+		};
+
+		void runFWQ (double* result);
+		void runFTQ (double* result);
+		void runSeries (CMSB::TimeSyncInfo* syncInfo, double* result);
+		void findPeaks (const double* detours, double* freqs, double* amps);
+		void printReport (const std::vector<double>& results);
+
+		int             _myRank;
+		int             _numProcs;
+		int             _node;
+		MPI_Comm        _nodeComm;
+		bool            _syncFailed;    // The last series did not start in sync
+		unsigned int    _fwqUnits;      // Work units per FWQ quantum
+		unsigned int    _ftqUnits;      // Work units per FTQ count
+		CMSB::ComputeKernel _kernel;
+		double          _maxNoiseFraction;
+		double          _samples[NUM_QUANTA];
+	};
+
+	void createNoiseMicroBenches (std::vector<MicroBench*>& benchmarks);
+}
+
+#endif      // __NOISE_BENCH_H__
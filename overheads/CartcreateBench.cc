@@ -26,24 +26,38 @@ void CMSB::CartcreateBench::init (MPI_Comm worldComm, CMSB::MicroBench::MicroBen
     
     _dims = new int[_numDims]; 
     _periods = new int[_numDims];
-    int num_procs_log = fastLog (_numProcs);
-    switch (_numDims) {
+    computeDims (_numProcs, _numDims, _dims, _periods);
+}
+
+
+void CMSB::CartcreateBench::computeDims (int numProcs, int numDims, int* dims, int* periods) {
+
+    int num_procs_log = fastLog (numProcs);
+    int num_grid_procs = 1;
+    switch (numDims) {
         case 1:
-            _dims[0] = _numProcs; 
-            _periods[0] = 0;
+            dims[0] = numProcs; 
+            periods[0] = 0;
             break;
         case 2:
-            _dims[0] = fastPow (num_procs_log / 2);
-            _dims[1] = _numProcs / _dims[0]; 
-            _periods[0] = _periods[1] = 0;
+            dims[0] = fastPow (num_procs_log / 2);
+            dims[1] = numProcs / dims[0]; 
+            periods[0] = periods[1] = 0;
             break;
         case 3:
             int exp = num_procs_log / 3;
-            _dims[0] = _dims[1] = fastPow (exp);
-            _dims[2] = fastPow (num_procs_log - (2 * exp));
-            _periods[0] = _periods[1] = _periods[2] = 0;
+            dims[0] = dims[1] = fastPow (exp);
+            dims[2] = fastPow (num_procs_log - (2 * exp));
+            periods[0] = periods[1] = periods[2] = 0;
             break;
     };
+
+    // The split above only covers powers of two
+    for (int i = 0; i < numDims; i++) num_grid_procs *= dims[i];
+    if (num_grid_procs != numProcs) {
+        for (int i = 0; i < numDims; i++) dims[i] = 0;
+        MPI_Dims_create (numProcs, numDims, dims);
+    }
 }
 
 
@@ -16,6 +16,10 @@ namespace CMSB {
         virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
 		virtual const char* getMicroBenchName  () const { return "MPI_Cart_create"; }
 		virtual void writeResultToProfile      () const { }
+
+        // Balanced non-periodic grid of numProcs ranks in numDims (1-3)
+        // dimensions - also used by the neighborhood collectives
+        static void computeDims (int numProcs, int numDims, int* dims, int* periods);
     
     protected:
         virtual unsigned int runOverheadFunc () {
@@ -28,8 +32,8 @@ namespace CMSB {
                 MPI_Comm_free (&_newComm[i]); 
         }
         
-        inline int fastLog (int powerTwoVal);
-        inline int fastPow (int exp);
+        static inline int fastLog (int powerTwoVal);
+        static inline int fastPow (int exp);
         
         int _numDims;
         int* _dims;
@@ -67,6 +67,8 @@ void CMSB::OverheadsBench::runMicroBench (CMSB::TimeSyncInfo* syncInfo) {
     double max_mem_consump[NUM_ITERS_TOTAL];
 	double errors[NUM_ITERS_ROUND];
 	double max_errors[NUM_ITERS_ROUND];
+	double sync_enters[NUM_ITERS_ROUND];
+	double sync_starts[NUM_ITERS_ROUND];
 	int total_num_valid_runs = 0;
 		
 	do {
@@ -83,6 +85,8 @@ void CMSB::OverheadsBench::runMicroBench (CMSB::TimeSyncInfo* syncInfo) {
 			double err = 0;
    
 			errors[i] = CMSB::nbcb_sync (syncInfo);
+			sync_enters[i] = syncInfo->_syncEnter;
+			sync_starts[i] = syncInfo->_syncStart;
         
             mem_before = 0.0;
             CMSB::MemEstimator::startLocalPeakMemMeasurement ();
@@ -98,6 +102,9 @@ void CMSB::OverheadsBench::runMicroBench (CMSB::TimeSyncInfo* syncInfo) {
             mem_consump[i] /= num_internal_iters;
             //mem_consump[i] = (mem_before > mem_after) ? (mem_before - mem_after) : (mem_after - mem_before);
 		}
+		for (int i = 0; i < NUM_ITERS_ROUND; i++) {
+			CMSB::sync_trace (syncInfo, sync_enters[i], sync_starts[i], errors[i]);
+		}
 		
 		// Check for errors in the synchronization process
 		MPI_Allreduce (errors, max_errors, NUM_ITERS_ROUND, MPI_DOUBLE, MPI_MAX, _worldComm);
@@ -120,6 +127,7 @@ void CMSB::OverheadsBench::runMicroBench (CMSB::TimeSyncInfo* syncInfo) {
                 }
             }
         }
+		CMSB::sync_report_errors (syncInfo, error_count, NUM_ITERS_ROUND);
 		// If more than 25% erros occured or there are less than 4 valid
 		// measurements, we should double the window size and re-run the
 		// round
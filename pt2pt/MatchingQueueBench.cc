@@ -0,0 +1,159 @@
+#include <iostream>
+#include <ios>
+#include <iomanip>
+#include <sstream>
+#include <timing/elg_pform_defs.h>
+#include <MemEstimator.h>
+#include "MatchingQueueBench.h"
+
+
+// The ping is tag 0, the queue entries are tags 1 to K
+#define PING_TAG 0
+
+
+CMSB::MatchingQueueBench::MatchingQueueBench (Queue queue, int queueDepth, bool wildcard,
+											  const CMSB::MatchingQueueBench* baseline)
+	: PointToPointBench (1, NEIGHBOR, 1, baseline),
+	  _queue (queue), _queueDepth (queueDepth), _wildcard (wildcard), _peakMem (0), _retainedMem (0) {
+}
+
+
+CMSB::MatchingQueueBench::~MatchingQueueBench () {
+}
+
+
+void CMSB::MatchingQueueBench::init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo) {
+
+	CMSB::PointToPointBench::init (worldComm, benchInfo);
+
+	// Every posted receive gets its own element
+	_sendBuff.assign (1, _myRank+1);
+	_recvBuff.assign (_queueDepth + 1, 0.0);
+	_requests.resize (_queueDepth);
+}
+
+
+void CMSB::MatchingQueueBench::runMicroBench (CMSB::TimeSyncInfo* syncInfo) {
+
+	// The heap of one full queue - the peak while it is filled and what
+	// the library holds on to once it is drained again
+	bool active = (_partner != MPI_PROC_NULL);
+	uint64_t mem_before = CMSB::MemEstimator::getCurrentMemConsumption ();
+	CMSB::MemEstimator::startLocalPeakMemMeasurement ();
+	if (active) startIteration ();
+	uint64_t peak_mem = CMSB::MemEstimator::getLocalPeakMemConsumption ();
+	if (active) runIteration ();
+	int64_t retained_mem = CMSB::MemEstimator::getCurrentMemConsumption () - mem_before;
+	MPI_Reduce (&peak_mem, &_peakMem, 1, MPI_UINT64_T, MPI_MAX, 0, _worldComm);
+	MPI_Reduce (&retained_mem, &_retainedMem, 1, MPI_INT64_T, MPI_MAX, 0, _worldComm);
+
+	CMSB::PointToPointBench::runMicroBench (syncInfo);
+
+	if (_myRank == 0) {
+		std::string label (getResultLabel ());
+		std::cout << label << ": queue peak memory (bytes) = " << _peakMem << std::endl;
+		std::cout << label << ": queue memory retained (bytes) = " << _retainedMem << std::endl;
+		if (_baseline != NULL) {
+			// The constructor only takes a MatchingQueueBench as the baseline
+			const CMSB::MatchingQueueBench* baseline = static_cast<const CMSB::MatchingQueueBench*> (_baseline);
+			int64_t mem_growth = (int64_t)(_peakMem - baseline->_peakMem);
+			std::cout << label << ": queue peak memory over " << baseline->getResultLabel () << " (bytes) = "
+					  << mem_growth << std::endl;
+			if (_queueDepth > baseline->_queueDepth) {
+				std::cout << label << ": queue memory per entry (bytes) = " << std::setprecision(6) << std::fixed
+						  << double (mem_growth) / (_queueDepth - baseline->_queueDepth) << std::endl;
+			}
+		}
+	}
+}
+
+
+std::string CMSB::MatchingQueueBench::getResultLabel () const {
+
+	std::ostringstream label;
+	label << CMSB::PointToPointBench::getResultLabel () << "[depth " << _queueDepth << "]";
+	if (_wildcard) label << "[any_source]";
+	return label.str ();
+}
+
+
+void CMSB::MatchingQueueBench::startIteration () {
+
+	if (_queue == UNEXPECTED) {
+		if (_isInitiator) {
+			for (int k = 1; k <= _queueDepth; k++) {
+				MPI_Send (&_sendBuff[0], 1, MPI_DOUBLE, _partner, k, _comm);
+			}
+		}
+		else if (_queueDepth > 0) {
+			// Messages of a sender arrive in order - once the last one is
+			// there the queue is full
+			MPI_Probe (_partner, _queueDepth, _comm, MPI_STATUS_IGNORE);
+		}
+	}
+	else if (!_isInitiator) {
+		for (int k = 1; k <= _queueDepth; k++) {
+			MPI_Irecv (&_recvBuff[k], 1, MPI_DOUBLE, _wildcard ? MPI_ANY_SOURCE : _partner, k, _comm,
+					   &_requests[k-1]);
+		}
+	}
+}
+
+
+double CMSB::MatchingQueueBench::runIteration () {
+
+	double ping_time = 0.0;
+	if (_isInitiator) {
+		double start_time = CMSB::elg_pform_wtime ();
+		MPI_Send (&_sendBuff[0], 1, MPI_DOUBLE, _partner, PING_TAG, _comm);
+		MPI_Recv (&_recvBuff[0], 1, MPI_DOUBLE, _partner, PING_TAG, _comm, MPI_STATUS_IGNORE);
+		ping_time = (CMSB::elg_pform_wtime () - start_time) * 1e6 / 2;     // Convert to usec
+	}
+	else {
+		int source = (_queue == UNEXPECTED && _wildcard) ? MPI_ANY_SOURCE : _partner;
+		MPI_Recv (&_recvBuff[0], 1, MPI_DOUBLE, source, PING_TAG, _comm, MPI_STATUS_IGNORE);
+		MPI_Send (&_sendBuff[0], 1, MPI_DOUBLE, _partner, PING_TAG, _comm);
+	}
+	drainQueue ();
+	return ping_time;
+}
+
+
+void CMSB::MatchingQueueBench::drainQueue () {
+
+	if (_queue == UNEXPECTED) {
+		if (!_isInitiator) {
+			for (int k = 1; k <= _queueDepth; k++) {
+				MPI_Recv (&_recvBuff[k], 1, MPI_DOUBLE, _partner, k, _comm, MPI_STATUS_IGNORE);
+			}
+		}
+	}
+	else if (_isInitiator) {
+		for (int k = 1; k <= _queueDepth; k++) {
+			MPI_Send (&_sendBuff[0], 1, MPI_DOUBLE, _partner, k, _comm);
+		}
+	}
+	else if (_queueDepth > 0) {
+		MPI_Waitall (_queueDepth, &_requests[0], MPI_STATUSES_IGNORE);
+	}
+}
+
+
+void CMSB::createMatchingQueueMicroBenches (std::vector<MicroBench*>& benchmarks) {
+
+	typedef CMSB::MatchingQueueBench MQ;
+
+	// The empty queue of each kind is the baseline, so it runs first
+	const int num_depths = 6;
+	int depths[num_depths] = { 0, 16, 64, 256, 1024, 4096 };
+	MQ::Queue queues[2] = { MQ::UNEXPECTED, MQ::POSTED };
+	for (int q = 0; q < 2; q++) {
+		for (int w = 0; w < 2; w++) {
+			CMSB::MatchingQueueBench* empty = new CMSB::MatchingQueueBench (queues[q], 0, w == 1);
+			benchmarks.push_back (empty);
+			for (int d = 1; d < num_depths; d++) {
+				benchmarks.push_back (new CMSB::MatchingQueueBench (queues[q], depths[d], w == 1, empty));
+			}
+		}
+	}
+}
@@ -0,0 +1,66 @@
+#ifndef __MATCHING_QUEUE_BENCH_H__
+#define __MATCHING_QUEUE_BENCH_H__
+
+
+#include <mpi.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "PointToPointBench.h"
+
+
+namespace CMSB {
+
+	/**
+	 * Ping-pong latency through long matching queues. Before each
+	 * iteration the partner's queue is filled with K entries that the
+	 * ping does not match: K unexpected messages sent ahead of it, or K
+	 * posted receives with other tags. The wildcard variant receives the
+	 * ping (unexpected queue) or posts the K receives (posted queue) with
+	 * MPI_ANY_SOURCE, which many libraries match on a slower path. The
+	 * queues are drained after the timed exchange. The heap the library
+	 * allocates for a full queue is reported next to the latency.
+	 */
+	class MatchingQueueBench : public CMSB::PointToPointBench {
+	public:
+
+		enum Queue {
+			UNEXPECTED,     // K messages that arrive before their receives
+			POSTED          // K receives that wait for other messages
+		};
+
+		// The baseline is not owned, it has to run before this benchmark
+		MatchingQueueBench (Queue queue, int queueDepth, bool wildcard,
+							const CMSB::MatchingQueueBench* baseline = NULL);
+		virtual ~MatchingQueueBench ();
+
+		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
+		virtual void runMicroBench (CMSB::TimeSyncInfo* syncInfo);
+		virtual const char* getMicroBenchName  () const { return (_queue == UNEXPECTED) ? "UnexpectedQueue" : "PostedQueue"; }
+		virtual unsigned int getMemConsumption () const {
+			return CMSB::PointToPointBench::getMemConsumption () + _requests.capacity () * sizeof (MPI_Request);
+		}
+
+		virtual std::string getResultLabel () const;
+
+	protected:
+		// Fills the queue of the partner
+		virtual void startIteration ();
+		virtual double runIteration ();
+		void drainQueue ();
+
+		Queue           _queue;
+		int             _queueDepth;
+		bool            _wildcard;
+		// Heap of a full queue at its peak and still held after draining
+		// it, the maximum over all ranks - rank 0 only
+		uint64_t        _peakMem;
+		int64_t         _retainedMem;
+		std::vector<MPI_Request>    _requests;
+	};
+
+	void createMatchingQueueMicroBenches (std::vector<MicroBench*>& benchmarks);
+}
+
+
+#endif   // __MATCHING_QUEUE_BENCH_H__
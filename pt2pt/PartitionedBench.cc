@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <iostream>
+#include <ios>
+#include <iomanip>
+#include <sstream>
+#include <timing/elg_pform_defs.h>
+#include "PartitionedBench.h"
+
+
+CMSB::PartitionedBench::PartitionedBench (Mode mode, int numPartitions, uint64_t partitionSize, int numThreads,
+										  const CMSB::PartitionedBench* baseline)
+	: PointToPointBench (numPartitions * partitionSize, NEIGHBOR, 0, baseline),
+	  _mode (mode), _numPartitions (numPartitions), _partitionSize (partitionSize), _numThreads (numThreads) {
+}
+
+
+CMSB::PartitionedBench::~PartitionedBench () {
+
+	_team.stop ();
+	freeRequests ();
+}
+
+
+void CMSB::PartitionedBench::init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo) {
+
+	CMSB::PointToPointBench::init (worldComm, benchInfo);
+	freeRequests ();
+
+	_sendBuff.assign (std::max ((uint64_t)1, _msgSize), _myRank+1);
+	_recvBuff.assign (std::max ((uint64_t)1, _msgSize), 0.0);
+	_threadStarts.assign (_numThreads, 0.0);
+	if (_mode == PARTITIONED) {
+		_requests.assign (1, MPI_REQUEST_NULL);
+#if MPI_VERSION >= 4
+		if (_isInitiator) {
+			MPI_Psend_init (&_sendBuff[0], _numPartitions, _partitionSize, MPI_DOUBLE, _partner, 0, _comm,
+							MPI_INFO_NULL, &_requests[0]);
+		}
+		else if (_partner != MPI_PROC_NULL) {
+			MPI_Precv_init (&_recvBuff[0], _numPartitions, _partitionSize, MPI_DOUBLE, _partner, 0, _comm,
+							MPI_INFO_NULL, &_requests[0]);
+		}
+#endif
+	}
+	else {
+		_requests.assign (_numPartitions, MPI_REQUEST_NULL);
+	}
+}
+
+
+void CMSB::PartitionedBench::runMicroBench (CMSB::TimeSyncInfo* syncInfo) {
+
+	if (_isInitiator) {
+		_team.start (_numThreads, sendPartitions, this);
+	}
+	CMSB::PointToPointBench::runMicroBench (syncInfo);
+	_team.stop ();
+}
+
+
+std::string CMSB::PartitionedBench::getResultLabel () const {
+
+	std::ostringstream label;
+	label << getMicroBenchName () << "[partitions " << _numPartitions << " x " << _partitionSize << "]"
+		  << "[threads " << _numThreads << "]";
+	return label.str ();
+}
+
+
+void CMSB::PartitionedBench::sendPartitions (void* bench, int thread) {
+
+	// Every thread produces every _numThreads-th partition
+	CMSB::PartitionedBench* self = (CMSB::PartitionedBench*)bench;
+	self->_threadStarts[thread] = CMSB::elg_pform_wtime ();
+	for (int p = thread; p < self->_numPartitions; p += self->_numThreads) {
+		if (self->_mode == PARTITIONED) {
+#if MPI_VERSION >= 4
+			MPI_Pready (p, self->_requests[0]);
+#endif
+		}
+		else {
+			MPI_Isend (&self->_sendBuff[p * self->_partitionSize], self->_partitionSize, MPI_DOUBLE,
+					   self->_partner, p, self->_comm, &self->_requests[p]);
+		}
+	}
+}
+
+
+void CMSB::PartitionedBench::startIteration () {
+
+	if (_mode == PARTITIONED) {
+#if MPI_VERSION >= 4
+		MPI_Start (&_requests[0]);
+#endif
+	}
+	else if (!_isInitiator) {
+		for (int p = 0; p < _numPartitions; p++) {
+			MPI_Irecv (&_recvBuff[p * _partitionSize], _partitionSize, MPI_DOUBLE, _partner, p, _comm, &_requests[p]);
+		}
+	}
+}
+
+
+double CMSB::PartitionedBench::runIteration () {
+
+	// Kept in global time to span the two ranks of the pair
+	if (_isInitiator) {
+		_team.run ();
+		MPI_Waitall (_requests.size (), &_requests[0], MPI_STATUSES_IGNORE);
+		return CMSB::sync_local_to_global (*std::min_element (_threadStarts.begin (), _threadStarts.end ()));
+	}
+	MPI_Waitall (_requests.size (), &_requests[0], MPI_STATUSES_IGNORE);
+	return CMSB::sync_local_to_global (CMSB::elg_pform_wtime ());
+}
+
+
+void CMSB::PartitionedBench::printMetrics (const std::string& label) const {
+
+	std::cout << label << ": bandwidth (MB/s) = " << std::setprecision(6) << std::fixed
+			  << _msgSize * sizeof (double) / _medianTime << std::endl;
+}
+
+
+void CMSB::PartitionedBench::freeRequests () {
+
+	// Only the partitioned requests are persistent
+	for (unsigned int i = 0; i < _requests.size (); i++) {
+		if (_requests[i] != MPI_REQUEST_NULL) {
+			MPI_Request_free (&_requests[i]);
+		}
+	}
+}
+
+
+void CMSB::createPartitionedMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc,
+										  int numThreads) {
+
+	int my_rank, provided = MPI_THREAD_SINGLE;
+	MPI_Comm_rank (MPI_COMM_WORLD, &my_rank);
+	MPI_Query_thread (&provided);
+	if (provided < MPI_THREAD_MULTIPLE) {
+		if (my_rank == 0) {
+			std::cout << "Partitioned: warning: MPI_THREAD_MULTIPLE is not provided,"
+					  << " running one thread only" << std::endl;
+		}
+		numThreads = 1;
+	}
+#if MPI_VERSION < 4
+	if (my_rank == 0) {
+		std::cout << "Partitioned: warning: MPI 4 is not available, running the MPI_Isend baselines only"
+				  << std::endl;
+	}
+#endif
+
+	// The same message in more and smaller partitions, then more
+	// partitions of the same size
+	const int num_counts = 4;
+	int counts[num_counts] = { 1, 4, 16, 64 };
+	for (int s = 0; s < 2; s++) {
+		for (int c = 0; c < num_counts; c++) {
+			uint64_t size = (s == 0) ? messageSizePerProc / counts[c] : messageSizePerProc / counts[num_counts-1];
+			if (size == 0) size = 1;
+			int threads = std::min (numThreads, counts[c]);
+			CMSB::PartitionedBench* isend = new CMSB::PartitionedBench (CMSB::PartitionedBench::ISEND,
+																		counts[c], size, threads);
+			benchmarks.push_back (isend);
+#if MPI_VERSION >= 4
+			benchmarks.push_back (new CMSB::PartitionedBench (CMSB::PartitionedBench::PARTITIONED,
+															  counts[c], size, threads, isend));
+#endif
+		}
+	}
+}
@@ -0,0 +1,74 @@
+#ifndef __PARTITIONED_BENCH_H__
+#define __PARTITIONED_BENCH_H__
+
+
+#include <mpi.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <util/ThreadTeam.h>
+#include "PointToPointBench.h"
+
+
+namespace CMSB {
+
+	/**
+	 * Partitioned point-to-point communication of MPI 4: the even ranks
+	 * send one message of numPartitions partitions to the next odd rank,
+	 * the partitions are marked ready by several threads as if they were
+	 * produced by them. The time is the span from the first MPI_Pready in
+	 * global time to the completion of the receive. The same partitions
+	 * sent as one MPI_Isend each, from the same threads, are the
+	 * baseline. Needs MPI_THREAD_MULTIPLE for more than one thread.
+	 */
+	class PartitionedBench : public CMSB::PointToPointBench {
+	public:
+
+		enum Mode {
+			PARTITIONED,    // MPI_Psend_init/MPI_Precv_init and MPI_Pready
+			ISEND           // One MPI_Isend/MPI_Irecv per partition
+		};
+
+		// The baseline is not owned, it has to run before this benchmark
+		PartitionedBench (Mode mode, int numPartitions, uint64_t partitionSize, int numThreads,
+						  const CMSB::PartitionedBench* baseline = NULL);
+		virtual ~PartitionedBench ();
+
+		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
+		virtual void runMicroBench (CMSB::TimeSyncInfo* syncInfo);
+		virtual const char* getMicroBenchName  () const { return (_mode == PARTITIONED) ? "MPI_Psend" : "MPI_Isend"; }
+		virtual unsigned int getMemConsumption () const {
+			return CMSB::PointToPointBench::getMemConsumption () + _requests.capacity () * sizeof (MPI_Request)
+				   + _threadStarts.capacity () * sizeof (double);
+		}
+
+		virtual std::string getResultLabel () const;
+
+	protected:
+		static void sendPartitions (void* bench, int thread);
+		virtual void startIteration ();
+		// Global time of the first MPI_Pready on the sender, of the
+		// completion on the receiver
+		virtual double runIteration ();
+		virtual double getPairTime (double initiatorValue, double partnerValue) const {
+			return (partnerValue - initiatorValue) * 1e6;     // Convert to usec
+		}
+		virtual void printMetrics (const std::string& label) const;
+		void freeRequests ();
+
+		Mode            _mode;
+		int             _numPartitions;
+		uint64_t        _partitionSize;     // In doubles
+		int             _numThreads;
+		std::vector<MPI_Request>    _requests;
+		std::vector<double>         _threadStarts;
+		CMSB::ThreadTeam            _team;
+	};
+
+	// Without MPI 4 only the MPI_Isend baselines are run
+	void createPartitionedMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc,
+										int numThreads);
+}
+
+
+#endif   // __PARTITIONED_BENCH_H__
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <iostream>
+#include <ios>
+#include <iomanip>
+#include <sstream>
+#include <timing/elg_pform_defs.h>
+#include <timing/SyncRounds.h>
+#include <util/NodeMap.h>
+#include <util/Statistics.h>
+#include "PointToPointBench.h"
+#include "PointToPointBenches.h"
+
+
+CMSB::PointToPointBench::PointToPointBench (uint64_t messageSize, Pairing pairing, int numPairs,
+											const CMSB::PointToPointBench* baseline)
+	: _msgSize (messageSize), _pairing (pairing), _numPairs (numPairs), _baseline (baseline),
+	  _myRank (0), _numProcs (0), _activePairs (0), _partner (MPI_PROC_NULL), _isInitiator (false),
+	  _comm (MPI_COMM_NULL), _medianTime (0.0) {
+}
+
+
+CMSB::PointToPointBench::~PointToPointBench () {
+
+	if (_comm != MPI_COMM_NULL) {
+		MPI_Comm_free (&_comm);
+	}
+}
+
+
+void CMSB::PointToPointBench::init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo) {
+
+	CMSB::MicroBench::init (worldComm, benchInfo);
+
+	MPI_Comm_rank (_worldComm, &_myRank);
+	MPI_Comm_size (_worldComm, &_numProcs);
+	if (_comm != MPI_COMM_NULL) {
+		MPI_Comm_free (&_comm);
+	}
+	MPI_Comm_dup (_worldComm, &_comm);
+
+	// The first _numPairs pairs of the pairing are active
+	int max_pairs = _numProcs / 2;
+	_activePairs = (_numPairs > 0 && _numPairs < max_pairs) ? _numPairs : max_pairs;
+	_pairs.resize (2 * _activePairs);
+	_partner = MPI_PROC_NULL;
+	_isInitiator = false;
+	for (int k = 0; k < _activePairs; k++) {
+		_pairs[2*k] = (_pairing == NEIGHBOR) ? 2*k : k;
+		_pairs[2*k+1] = (_pairing == NEIGHBOR) ? 2*k+1 : k + max_pairs;
+		if (_myRank == _pairs[2*k]) {
+			_partner = _pairs[2*k+1];
+			_isInitiator = true;
+		}
+		else if (_myRank == _pairs[2*k+1]) {
+			_partner = _pairs[2*k];
+		}
+	}
+
+	CMSB::gatherRankNodes (_worldComm, _rankNodes);
+}
+
+
+void CMSB::PointToPointBench::runMicroBench (CMSB::TimeSyncInfo* syncInfo) {
+
+	bool active = (_partner != MPI_PROC_NULL);
+
+	// The warmups size the sync window
+	double warmup_time = 0.0, max_warmup_time = 0.0;
+	for (int i = 0; i < NUM_WARMUP_ITERS; i++) {
+		if (active) startIteration ();
+		MPI_Barrier (_worldComm);
+		double start_time = CMSB::elg_pform_wtime ();
+		if (active) runIteration ();
+		warmup_time += (CMSB::elg_pform_wtime () - start_time) * 1e6;     // Convert to usec
+	}
+	warmup_time /= NUM_WARMUP_ITERS;
+	MPI_Allreduce (&warmup_time, &max_warmup_time, 1, MPI_DOUBLE, MPI_MAX, _worldComm);
+	syncInfo->_esttime = max_warmup_time;
+
+	// All pairs start at the same time
+	std::vector<double> values;
+	double round_values[NUM_ITERS_ROUND];
+	CMSB::SyncRounds rounds (_worldComm, syncInfo, NUM_ITERS_ROUND, NUM_ITERS_TOTAL);
+	while (rounds.nextRound ()) {
+		for (int i = 0; i < NUM_ITERS_ROUND; i++) {
+			if (active) startIteration ();
+			rounds.sync (i);
+			round_values[i] = active ? runIteration () : 0.0;
+		}
+		if (!rounds.endRound ()) continue;
+		const std::vector<int>& kept_iters = rounds.getKeptIters ();
+		for (size_t i = 0; i < kept_iters.size (); i++) {
+			values.push_back (round_values[kept_iters[i]]);
+		}
+	}
+
+	std::vector<double> all_values ((_myRank == 0) ? _numProcs * NUM_ITERS_TOTAL : 0);
+	MPI_Gather (&values[0], NUM_ITERS_TOTAL, MPI_DOUBLE, (_myRank == 0) ? &all_values[0] : NULL,
+				NUM_ITERS_TOTAL, MPI_DOUBLE, 0, _worldComm);
+	if (_myRank == 0) {
+		printReport (all_values, rounds.getNumErrors (), rounds.getNumSyncs ());
+	}
+}
+
+
+std::string CMSB::PointToPointBench::getResultLabel () const {
+
+	std::ostringstream label;
+	label << getMicroBenchName () << "[" << _msgSize << " doubles]"
+		  << "[" << ((_pairing == NEIGHBOR) ? "neighbor" : "halves") << " pairs " << _activePairs << "]";
+	return label.str ();
+}
+
+
+void CMSB::PointToPointBench::printReport (const std::vector<double>& values, int numErrors, int numSyncs) {
+
+	std::string label (getResultLabel ());
+	std::cout << label << ": total runs = " << NUM_ITERS_TOTAL << std::endl;
+	std::cout << label << ": sync error rate = " << std::setprecision(6) << std::fixed
+			  << double (numErrors) / numSyncs << std::endl;
+	if (_activePairs == 0) return;
+
+	// An iteration lasts as long as its slowest pair
+	std::vector<double> max_times (NUM_ITERS_TOTAL, 0.0);
+	std::vector<double> class_medians[2];       // Intra-node and inter-node pairs
+	for (int k = 0; k < _activePairs; k++) {
+		int initiator = _pairs[2*k], partner = _pairs[2*k+1];
+		bool intra_node = (_rankNodes[initiator] == _rankNodes[partner]);
+		std::vector<double> pair_times (NUM_ITERS_TOTAL);
+		for (int i = 0; i < NUM_ITERS_TOTAL; i++) {
+			pair_times[i] = getPairTime (values[initiator*NUM_ITERS_TOTAL + i], values[partner*NUM_ITERS_TOTAL + i]);
+			max_times[i] = std::max (max_times[i], pair_times[i]);
+		}
+		double pair_median = median (pair_times);
+		class_medians[intra_node ? 0 : 1].push_back (pair_median);
+		std::cout << label << ": pair " << initiator << "-" << partner
+				  << (intra_node ? " (intra-node)" : " (inter-node)") << " median = "
+				  << std::setprecision(6) << std::fixed << pair_median << std::endl;
+	}
+	for (int c = 0; c < 2; c++) {
+		if (class_medians[c].empty ()) continue;
+		std::cout << label << ": " << ((c == 0) ? "intra-node" : "inter-node") << " pairs = "
+				  << class_medians[c].size () << ", median of pair medians = " << std::setprecision(6)
+				  << std::fixed << median (class_medians[c]) << std::endl;
+	}
+	_medianTime = median (max_times);
+	std::cout << label << ": median = " << std::setprecision(6) << std::fixed << _medianTime << std::endl;
+	printMetrics (label);
+	if (_baseline != NULL) {
+		std::cout << label << ": relative to " << _baseline->getResultLabel () << " = "
+				  << std::setprecision(6) << std::fixed << _medianTime / _baseline->getMicroBenchResult ()
+				  << std::endl;
+	}
+}
+
+
+void CMSB::createPointToPointMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc) {
+
+	typedef CMSB::PointToPointBench P2P;
+
+	// Neighbors are mostly on the same node, the halves on different ones
+	P2P::Pairing pairings[2] = { P2P::NEIGHBOR, P2P::HALVES };
+	for (int p = 0; p < 2; p++) {
+		benchmarks.push_back (new CMSB::PingPongBench (1, pairings[p], 1));
+		benchmarks.push_back (new CMSB::PingPongBench (messageSizePerProc, pairings[p], 1));
+		benchmarks.push_back (new CMSB::BandwidthBench (messageSizePerProc, CMSB::BandwidthBench::WINDOW_SIZE,
+														false, pairings[p], 1));
+		benchmarks.push_back (new CMSB::BandwidthBench (messageSizePerProc, CMSB::BandwidthBench::WINDOW_SIZE,
+														true, pairings[p], 1));
+	}
+
+	// Small messages from more and more concurrent pairs - the single
+	// pair is the baseline
+	int num_procs;
+	MPI_Comm_size (MPI_COMM_WORLD, &num_procs);
+	CMSB::PointToPointBench* single = new CMSB::MessageRateBench (1, P2P::HALVES, 1);
+	benchmarks.push_back (single);
+	for (int n = 2; n <= num_procs/2; n = (n < num_procs/2 && 2*n > num_procs/2) ? num_procs/2 : 2*n) {
+		benchmarks.push_back (new CMSB::MessageRateBench (1, P2P::HALVES, n, single));
+	}
+}
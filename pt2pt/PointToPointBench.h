@@ -0,0 +1,91 @@
+#ifndef __POINT_TO_POINT_BENCH_H__
+#define __POINT_TO_POINT_BENCH_H__
+
+
+#include <mpi.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <MicroBench.h>
+
+
+namespace CMSB {
+
+	/**
+	 * Base class for point-to-point benchmarks between pairs of ranks. The
+	 * initiator of a pair starts the exchange, the partner answers it,
+	 * ranks outside the active pairs only take part in the syncs. All
+	 * pairs start in the same sync window, so several pairs measure the
+	 * contention among them. Every rank reports one value per iteration,
+	 * the pair's time is computed from the values of its two ranks. Pairs
+	 * are classified as intra-node or inter-node by the shared-memory
+	 * node of their ranks.
+	 */
+	class PointToPointBench : public CMSB::MicroBench {
+	public:
+
+		enum Pairing {
+			NEIGHBOR,       // Rank 2k with 2k+1 - usually on the same node
+			HALVES          // Rank k with k+P/2 - usually on different nodes
+		};
+
+		static const int NUM_WARMUP_ITERS = 10;
+
+		// Iterations are performed in rounds, a round with too many
+		// failed syncs is repeated with a larger window
+		static const int NUM_ITERS_ROUND = 20;
+		static const int NUM_ITERS_TOTAL = 100;
+
+		// numPairs 0 makes all ranks pairs. The baseline is not owned, it
+		// has to run before this benchmark.
+		PointToPointBench (uint64_t messageSize, Pairing pairing, int numPairs,
+						   const CMSB::PointToPointBench* baseline = NULL);
+		virtual ~PointToPointBench ();
+
+		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
+		virtual void runMicroBench (CMSB::TimeSyncInfo* syncInfo);
+		virtual double getMicroBenchResult     () const { return _medianTime; }
+		virtual void writeResultToProfile      () const { }
+		virtual unsigned int getMemConsumption () const {
+			return sizeof (CMSB::PointToPointBench) + (_sendBuff.capacity () + _recvBuff.capacity ()) * sizeof (double)
+				   + (_pairs.capacity () + _rankNodes.capacity ()) * sizeof (int);
+		}
+
+		// Prefix of the result lines - the name plus the measured variant
+		virtual std::string getResultLabel () const;
+
+	protected:
+		// Called on the ranks of the active pairs before the sync
+		virtual void startIteration () { }
+		// The measured exchange - returns the value of this rank
+		virtual double runIteration () = 0;
+		// Time of a pair in usec from the values of its two ranks
+		virtual double getPairTime (double initiatorValue, double) const { return initiatorValue; }
+		// Results beyond the times, from the median - rank 0 only
+		virtual void printMetrics (const std::string&) const { }
+		void printReport (const std::vector<double>& values, int numErrors, int numSyncs);
+
+		uint64_t        _msgSize;       // In number of doubles to send
+		Pairing         _pairing;
+		int             _numPairs;
+		const CMSB::PointToPointBench* _baseline;
+		int             _myRank;
+		int             _numProcs;
+		int             _activePairs;
+		int             _partner;       // MPI_PROC_NULL outside the active pairs
+		bool            _isInitiator;
+		MPI_Comm        _comm;
+		double          _medianTime;
+		// Initiator and partner of every active pair
+		std::vector<int>    _pairs;
+		// Node (named after the rank of its leader) of every rank - rank 0 only
+		std::vector<int>    _rankNodes;
+		std::vector<double> _sendBuff;
+		std::vector<double> _recvBuff;
+	};
+
+	void createPointToPointMicroBenches (std::vector<MicroBench*>& benchmarks, uint64_t messageSizePerProc);
+}
+
+
+#endif   // __POINT_TO_POINT_BENCH_H__
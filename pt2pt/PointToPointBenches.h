@@ -0,0 +1,118 @@
+#ifndef __POINT_TO_POINT_BENCHES_H__
+#define __POINT_TO_POINT_BENCHES_H__
+
+
+#include <mpi.h>
+#include <algorithm>
+#include <iostream>
+#include <ios>
+#include <iomanip>
+#include <timing/elg_pform_defs.h>
+#include "PointToPointBench.h"
+
+
+namespace CMSB {
+
+	// Half the round trip of a message and its echo
+	class PingPongBench : public CMSB::PointToPointBench {
+	public:
+		PingPongBench (uint64_t messageSize, Pairing pairing, int numPairs)
+			: PointToPointBench (messageSize, pairing, numPairs) {}
+		virtual const char* getMicroBenchName () const { return "PingPong"; }
+		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo) {
+			CMSB::PointToPointBench::init (worldComm, benchInfo);
+			_sendBuff.assign (std::max ((uint64_t)1, _msgSize), _myRank+1);
+			_recvBuff.assign (std::max ((uint64_t)1, _msgSize), 0.0);
+		}
+	protected:
+		virtual double runIteration () {
+			double start_time = CMSB::elg_pform_wtime ();
+			if (_isInitiator) {
+				MPI_Send (&_sendBuff[0], _msgSize, MPI_DOUBLE, _partner, 0, _comm);
+				MPI_Recv (&_recvBuff[0], _msgSize, MPI_DOUBLE, _partner, 0, _comm, MPI_STATUS_IGNORE);
+			}
+			else {
+				MPI_Recv (&_recvBuff[0], _msgSize, MPI_DOUBLE, _partner, 0, _comm, MPI_STATUS_IGNORE);
+				MPI_Send (&_sendBuff[0], _msgSize, MPI_DOUBLE, _partner, 0, _comm);
+			}
+			return (CMSB::elg_pform_wtime () - start_time) * 1e6 / 2;     // Convert to usec
+		}
+	};
+
+	/**
+	 * A window of messages in flight at once. Unidirectional: the
+	 * initiator sends, the partner acknowledges the whole window with an
+	 * empty message. Bidirectional: both send a window to each other, the
+	 * pair takes as long as the slower of the two.
+	 */
+	class BandwidthBench : public CMSB::PointToPointBench {
+	public:
+		static const int WINDOW_SIZE = 64;
+
+		BandwidthBench (uint64_t messageSize, int windowSize, bool bidirectional, Pairing pairing, int numPairs,
+						const CMSB::PointToPointBench* baseline = NULL)
+			: PointToPointBench (messageSize, pairing, numPairs, baseline),
+			  _windowSize (windowSize), _bidirectional (bidirectional) {}
+		virtual const char* getMicroBenchName () const { return _bidirectional ? "BiBandwidth" : "Bandwidth"; }
+		virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo) {
+			CMSB::PointToPointBench::init (worldComm, benchInfo);
+			_sendBuff.assign (std::max ((uint64_t)1, _windowSize * _msgSize), _myRank+1);
+			_recvBuff.assign (std::max ((uint64_t)1, _windowSize * _msgSize), 0.0);
+			_requests.resize (2 * _windowSize);
+		}
+		virtual unsigned int getMemConsumption () const {
+			return CMSB::PointToPointBench::getMemConsumption () + _requests.capacity () * sizeof (MPI_Request);
+		}
+	protected:
+		virtual double runIteration () {
+			double start_time = CMSB::elg_pform_wtime ();
+			int num_requests = 0;
+			if (_bidirectional || !_isInitiator) {
+				for (int w = 0; w < _windowSize; w++) {
+					MPI_Irecv (&_recvBuff[w * _msgSize], _msgSize, MPI_DOUBLE, _partner, 0, _comm,
+							   &_requests[num_requests++]);
+				}
+			}
+			if (_bidirectional || _isInitiator) {
+				for (int w = 0; w < _windowSize; w++) {
+					MPI_Isend (&_sendBuff[w * _msgSize], _msgSize, MPI_DOUBLE, _partner, 0, _comm,
+							   &_requests[num_requests++]);
+				}
+			}
+			MPI_Waitall (num_requests, &_requests[0], MPI_STATUSES_IGNORE);
+			if (!_bidirectional) {
+				if (_isInitiator) MPI_Recv (NULL, 0, MPI_BYTE, _partner, 1, _comm, MPI_STATUS_IGNORE);
+				else MPI_Send (NULL, 0, MPI_BYTE, _partner, 1, _comm);
+			}
+			return (CMSB::elg_pform_wtime () - start_time) * 1e6;     // Convert to usec
+		}
+		virtual double getPairTime (double initiatorValue, double partnerValue) const {
+			return _bidirectional ? std::max (initiatorValue, partnerValue) : initiatorValue;
+		}
+		virtual void printMetrics (const std::string& label) const {
+			// Over all active pairs, an iteration lasts as long as the slowest
+			double num_msgs = (_bidirectional ? 2.0 : 1.0) * _windowSize * _activePairs;
+			std::cout << label << ": aggregate bandwidth (MB/s) = " << std::setprecision(6) << std::fixed
+					  << num_msgs * _msgSize * sizeof (double) / _medianTime << std::endl;
+			std::cout << label << ": aggregate message rate (msgs/s) = " << std::setprecision(6) << std::fixed
+					  << num_msgs * 1e6 / _medianTime << std::endl;
+		}
+
+		int                         _windowSize;
+		bool                        _bidirectional;
+		std::vector<MPI_Request>    _requests;
+	};
+
+	// Unidirectional windows of small messages from N concurrent pairs
+	class MessageRateBench : public CMSB::BandwidthBench {
+	public:
+		MessageRateBench (uint64_t messageSize, Pairing pairing, int numPairs,
+						  const CMSB::PointToPointBench* baseline = NULL)
+			: BandwidthBench (messageSize, WINDOW_SIZE, false, pairing, numPairs, baseline) {}
+		virtual const char* getMicroBenchName () const { return "MessageRate"; }
+	};
+
+}
+
+
+#endif   // __POINT_TO_POINT_BENCHES_H__
@@ -8,8 +8,10 @@
  */
  
 #include <iostream>
+#include <time.h>
 #include "elg_pform_defs.h"
 #include "ClockSync.h"
+#include "EventTrace.h"
 
 #ifdef SYNC_BARRIER
 // Simple MPI_Barrier synchronization mechanism
@@ -26,6 +28,23 @@ double CMSB::nbcb_sync (CMSB::TimeSyncInfo* syncInfo) {
 	MPI_Barrier (syncInfo->_comm);
 	return 0;
 }
+
+void CMSB::sync_report_errors (CMSB::TimeSyncInfo* syncInfo, int numErrors, int numSyncs) {
+
+}
+
+void CMSB::sync_trace (CMSB::TimeSyncInfo* syncInfo, double enterTime, double startTime, double err) {
+
+}
+
+double CMSB::sync_local_to_global (double localTime) {
+
+    return localTime;
+}
+
+void CMSB::sync_finalize (CMSB::TimeSyncInfo* syncInfo) {
+
+}
 #endif
 
 #ifdef SYNC_DISSEMINATION
@@ -62,13 +81,30 @@ double CMSB::nbcb_sync (CMSB::TimeSyncInfo* syncInfo) {
 
     return 0;
 }
+
+void CMSB::sync_report_errors (CMSB::TimeSyncInfo* syncInfo, int numErrors, int numSyncs) {
+
+}
+
+void CMSB::sync_trace (CMSB::TimeSyncInfo* syncInfo, double enterTime, double startTime, double err) {
+
+}
+
+double CMSB::sync_local_to_global (double localTime) {
+
+    return localTime;
+}
+
+void CMSB::sync_finalize (CMSB::TimeSyncInfo* syncInfo) {
+
+}
 #endif
 
 #ifdef SYNC_WINDOW
-static double *diffs = NULL;    // global array of all diffs to all ranks - only
-                                // completely valid on rank 0
 static double gdiff = 0;    // the is the final time diff to rank 0 :-)
-static double gnext = 0;    // start-time for next round - synchronized with rank 0
+static double gskew = 0;    // drift of gdiff per second of local time
+static double gepoch = 0;   // local time at which gdiff was measured
+static double gnext = 0;    // start-time for next round - in rank 0's time
 
 #define NUMBER_SMALLER 100  // do RTT measurement until n successive
                             // messages are *not* smaller than the current
@@ -76,28 +112,76 @@ static double gnext = 0;    // start-time for next round - synchronized with ran
                            
 #define MAX_DOUBLE 1e99
 
-// time-window based synchronization mechanism 
-void CMSB::sync_init_stage1 (CMSB::TimeSyncInfo* syncInfo) {
+#define MAX_TREE_DEPTH 32   // a rank is client in at most log2(p) rounds
+
+#define MAX_SYNC_EPOCHS 8   // number of past sync epochs the drift is fitted to
+#define MIN_SKEW_SPAN 1.0   // epochs have to span at least this many seconds
+                            // before a drift is estimated from them
+
+#define RESYNC_ERR_RATE 0.25    // re-sync once the smoothed error rate exceeds this
+#define RESYNC_MIN_ROUNDS 8     // but not more often than every n rounds
+#define ERR_RATE_DECAY 0.5      // weight of the history in the smoothed error rate
+
+static double epoch_times[MAX_SYNC_EPOCHS];     // local times of past sync epochs
+static double epoch_diffs[MAX_SYNC_EPOCHS];     // diffs to rank 0 measured at them
+static int num_epochs = 0;
+
+/* adds a new sync epoch to the clock model. The offset to rank 0 is
+ * modelled as gdiff + gskew*(t-gepoch), anchored at the newest epoch; the
+ * skew is the least-squares slope over all stored epochs. */
+static void update_clock_model (double t, double diff) {
+
+    int i;
+
+    if (num_epochs == MAX_SYNC_EPOCHS) {
+        for (i=1; i<MAX_SYNC_EPOCHS; i++) {
+            epoch_times[i-1] = epoch_times[i];
+            epoch_diffs[i-1] = epoch_diffs[i];
+        }
+        num_epochs--;
+    }
+    epoch_times[num_epochs] = t;
+    epoch_diffs[num_epochs] = diff;
+    num_epochs++;
+
+    gdiff = diff;
+    gepoch = t;
+
+    if (num_epochs > 1 && t - epoch_times[0] >= MIN_SKEW_SPAN) {
+        double mean_t = 0, mean_d = 0, cov = 0, var = 0;
+        for (i=0; i<num_epochs; i++) {
+            mean_t += epoch_times[i];
+            mean_d += epoch_diffs[i];
+        }
+        mean_t /= num_epochs;
+        mean_d /= num_epochs;
+        for (i=0; i<num_epochs; i++) {
+            cov += (epoch_times[i]-mean_t) * (epoch_diffs[i]-mean_d);
+            var += (epoch_times[i]-mean_t) * (epoch_times[i]-mean_t);
+        }
+        gskew = cov / var;
+    }
+}
+
+/* converts a time of rank 0 to local time: solves t = tglobal - diff(t) */
+static double global_to_local (double tglobal) {
+
+    return (tglobal - gdiff + gskew*gepoch) / (1.0 + gskew);
+}
+
+/* synchronizes the clocks of all ranks in comm with rank 0 of comm along a
+ * binomial tree and returns the time diff of this rank to rank 0 */
+static double sync_tree (MPI_Comm comm) {
     
     int p, r, res, dist, round;
-    MPI_Comm comm = syncInfo->_comm;
+    int parent = -1;                        // the client we were server for
+    int children[MAX_TREE_DEPTH];           // the servers we were client for
+    double child_diffs[MAX_TREE_DEPTH];     // and their diffs to us
+    int num_children = 0;
+    double gdiff_tree = 0;                  // rank 0 has no diff to itself
 
     res = MPI_Comm_rank (comm, &r);
     res = MPI_Comm_size (comm, &p);
-  
-    // reallocate the diffs array with the right size
-    if (diffs != NULL) delete[] diffs;
-    diffs = new double[p]();    // initialize all values to 0
-  
-    // check if p is power of 2
-    { 
-        int i=1;
-        while((i = i << 1) < p) {};
-        if(i != p) {
-            std::cerr << "Communicator size" << p << " must be power of 2!" << std::endl;
-            MPI_Abort (MPI_COMM_WORLD, 1);
-        }
-    }
 
     dist = 1;   // this gets left-shifted (<<) every round and is after 
                 // $\lceil log_2(p) \rceil$ rounds >= p */
@@ -123,9 +207,11 @@ void CMSB::sync_init_stage1 (CMSB::TimeSyncInfo* syncInfo) {
             peer = r + dist;
             if (peer >= p) client = 0;
         }
-        if(!client && !server) break;   // TODO: leave loop if no peer left -
-                                        // works only for power of two process
-                                        // groups
+        if(!client && !server) {    // no peer in this round - but maybe in
+            dist = dist << 1;       // one of the next ones if p is not a
+            round++;                // power of two
+            continue;
+        }
 
         // synchronize clocks with peer
         {
@@ -142,10 +228,10 @@ void CMSB::sync_init_stage1 (CMSB::TimeSyncInfo* syncInfo) {
                  * with this smallest RTT with the scheme described in the paper.
                  * */
                 if (client) {
-                    tstart = elg_pform_wtime ();
+                    tstart = CMSB::elg_pform_wtime ();
                     res = MPI_Send (&tstart, 1, MPI_DOUBLE, peer, 0, comm);
                     res = MPI_Recv (&trem, 1, MPI_DOUBLE, peer, 0, comm, MPI_STATUS_IGNORE);
-                    tend = elg_pform_wtime ();
+                    tend = CMSB::elg_pform_wtime ();
                     tmpdiff = tstart + (tend-tstart)/2 - trem;
         
                     if (tend-tstart < smallest) {
@@ -169,7 +255,7 @@ void CMSB::sync_init_stage1 (CMSB::TimeSyncInfo* syncInfo) {
          
                     res = MPI_Recv (&tstart, 1, MPI_DOUBLE, peer, 0, comm, MPI_STATUS_IGNORE);
                     if(tstart == 0) break;  // this is the signal from the client to stop
-                    trem = elg_pform_wtime ();     // fill in local time on server
+                    trem = CMSB::elg_pform_wtime ();     // fill in local time on server
                     res = MPI_Send (&trem, 1, MPI_DOUBLE, peer, 0, comm);
                 }
                 // this loop is only left with a break
@@ -177,57 +263,15 @@ void CMSB::sync_init_stage1 (CMSB::TimeSyncInfo* syncInfo) {
         }
     
         /* the client measured the time difference to his peer-server of the
-         * current round. Since rank 0 is the global synchronization point,
-         * rank 0's array has to be up to date and the other clients have to
-         * communicate all their knowledge to rank 0 as described in the
-         * paper. */
-    
+         * current round. It only remembers it - the diffs to rank 0 are
+         * composed on the way down the tree. */
         if (client) {
-            // all clients just measured the time difference to node r + diff (=peer)
-            diffs[peer] = diff;
-
-            /* we are a client - we need to receive all the knowledge
-             * (differences) that the server we just synchronized with holds!
-             * Our server has been "round-1" times client and measures
-             * "round-1" diffs */
-            if(round > 1) {
-                double *recvbuf;    // receive the server's data
-                int items, i;
-
-                items = (1 << (round-1))-1;
-                recvbuf = new double[items];
-        
-                res = MPI_Recv (recvbuf, items, MPI_DOUBLE, peer, 0, comm, MPI_STATUS_IGNORE);
-        
-                // merge data into my own field
-                for(i=0; i<items; i++) {
-                    diffs[peer+i+1] =  diffs[peer] /* diff to server */ + 
-                            recvbuf[i] /* received time */; // TODO: + or - ???
-                }
-                delete[] recvbuf;
-            }
+            children[num_children] = peer;
+            child_diffs[num_children] = diff;
+            num_children++;
         }
-
-        if(server) {
-            /* we are a server, we need to send all our knowledge (time
-             * differences to our client */
-    
-            /* we have measured "round-1" nodes at the end of round "round"
-             * and hold $2^(round-1)-1$ diffs at this time*/
-            if(round > 1) {
-                int i, tmpdist, tmppeer, items;
-                double *sendbuf;
-        
-                items = (1 << (round-1))-1;
-                sendbuf = new double[items];
-
-                // fill buffer - every server holds the $2^(round-1)-1$ next diffs
-                for(i=0; i<items; i++) {
-                    sendbuf[i] = diffs[r+i+1];
-                }
-                res = MPI_Send (sendbuf, items, MPI_DOUBLE, peer, 0, comm);
-                delete[] sendbuf;
-            }
+        if (server) {
+            parent = peer;
         }
     
         dist = dist << 1;
@@ -235,12 +279,58 @@ void CMSB::sync_init_stage1 (CMSB::TimeSyncInfo* syncInfo) {
         
     } while (dist < p);
 
+    /* every rank receives its diff to rank 0 from its client and passes
+     * diff + (diff of the server to us) on to its own servers - the largest
+     * subtree first. No rank ever holds more than log2(p) diffs. */
+    if (parent >= 0) {
+        res = MPI_Recv (&gdiff_tree, 1, MPI_DOUBLE, parent, 0, comm, MPI_STATUS_IGNORE);
+    }
+    while (num_children > 0) {
+        double diff;
 
-    // scatter all the time diffs to the processes
-    MPI_Scatter (diffs, 1, MPI_DOUBLE, &gdiff, 1, MPI_DOUBLE, 0, comm);
+        num_children--;
+        diff = gdiff_tree + child_diffs[num_children];
+        res = MPI_Send (&diff, 1, MPI_DOUBLE, children[num_children], 0, comm);
+    }
+
+    return gdiff_tree;
+}
+
+// time-window based synchronization mechanism 
+void CMSB::sync_init_stage1 (CMSB::TimeSyncInfo* syncInfo) {
+    
+    int r, nr;
+    double diff = 0;
+    double tstart = elg_pform_wtime ();
+    MPI_Comm comm = syncInfo->_comm;
+
+    MPI_Comm_rank (comm, &r);
+
+    /* ranks on the same node read the same clock - only one leader per
+     * node takes part in the synchronization tree and hands its diff to
+     * the other ranks of its node. Rank 0 is always a leader. The node
+     * split is kept until sync_finalize. */
+    if (syncInfo->_nodeComm == MPI_COMM_NULL) {
+#if defined(SYNC_FLAT_TREE) || MPI_VERSION < 3
+        MPI_Comm_split (comm, r, 0, &syncInfo->_nodeComm);
+#else
+        MPI_Comm_split_type (comm, MPI_COMM_TYPE_SHARED, r, MPI_INFO_NULL, &syncInfo->_nodeComm);
+#endif
+        MPI_Comm_rank (syncInfo->_nodeComm, &nr);
+        MPI_Comm_split (comm, (nr == 0) ? 0 : MPI_UNDEFINED, r, &syncInfo->_leaderComm);
+    }
+
+    if (syncInfo->_leaderComm != MPI_COMM_NULL) {
+        diff = sync_tree (syncInfo->_leaderComm);
+    }
+    MPI_Bcast (&diff, 1, MPI_DOUBLE, 0, syncInfo->_nodeComm);
+    update_clock_model (elg_pform_wtime (), diff);
+    CMSB::trace_event ("clock_sync", "sync", tstart, elg_pform_wtime ());
 
     // initialize window to 0
     syncInfo->_window = 0;
+    syncInfo->_errRate = 0;
+    syncInfo->_roundsSinceSync = 0;
 }
 
 // done at the beginning of every new size
@@ -250,15 +340,15 @@ void CMSB::sync_init_stage2 (CMSB::TimeSyncInfo* syncInfo) {
     int i;
     MPI_Comm comm = syncInfo->_comm;
 
-#if 0
-    // we increased the window size? - we need to re-synch
-    if(syncInfo->_window != 0) {
+    // too many syncs failed recently? - the clocks drifted, we need to re-synch
+    if (syncInfo->_errRate > RESYNC_ERR_RATE &&
+        syncInfo->_roundsSinceSync >= RESYNC_MIN_ROUNDS) {
         /* save increased window size */
         win = syncInfo->_window;
         sync_init_stage1 (syncInfo);
         syncInfo->_window = win;
     }
-#endif
+    syncInfo->_roundsSinceSync++;
 
     //if(!mpiargs->rank) printf("estimated time: %lf\n", mpiargs->esttime);
     win = syncInfo->_esttime/1e6 * 1.25;    // esttime is in usec - window
@@ -266,43 +356,130 @@ void CMSB::sync_init_stage2 (CMSB::TimeSyncInfo* syncInfo) {
                                             // estimated MPI time
 
     if (win > syncInfo->_window) syncInfo->_window = win;
-    MPI_Bcast (&syncInfo->_window, 1, MPI_DOUBLE, 0, comm);
+
+    /* the window only changes collectively (max. estimated time, doubling
+     * after failed rounds) - re-arm fully only then, otherwise reuse the
+     * cached bcast time */
+    if (syncInfo->_window != syncInfo->_armedWindow) {
+        MPI_Bcast (&syncInfo->_window, 1, MPI_DOUBLE, 0, comm);
   
-    // it has been used before - so it is "warm" :)
-    bcasttime = -elg_pform_wtime ();
-    for(i=0; i<10; i++) {
-        MPI_Bcast(&gnext, 1, MPI_DOUBLE, 0, comm);
+        // it has been used before - so it is "warm" :)
+        bcasttime = -elg_pform_wtime ();
+        for(i=0; i<10; i++) {
+            MPI_Bcast(&gnext, 1, MPI_DOUBLE, 0, comm);
+        }
+        bcasttime += elg_pform_wtime();
+        gnext = bcasttime;  // dummy buffer
+        // get maximum bcasttime
+        MPI_Reduce (&gnext, &syncInfo->_bcastTime, 1, MPI_DOUBLE, MPI_MAX, 0, comm);
+
+        syncInfo->_armedWindow = syncInfo->_window;
     }
-    bcasttime += elg_pform_wtime();
-    gnext = bcasttime;  // dummy buffer
-    // get maximum bcasttime
-    MPI_Reduce (&gnext, &bcasttime, 1, MPI_DOUBLE, MPI_MAX, 0, comm);
 
     // rank 0 sets base-time to a time when the bcast is expected to be finished
-    gnext = elg_pform_wtime () + bcasttime;
+    gnext = elg_pform_wtime () + syncInfo->_bcastTime;
     MPI_Bcast (&gnext, 1, MPI_DOUBLE, 0, comm);
+}
+
+// after every round - numErrors has to be the same on all ranks
+void CMSB::sync_report_errors (CMSB::TimeSyncInfo* syncInfo, int numErrors, int numSyncs) {
+
+    syncInfo->_errRate = ERR_RATE_DECAY * syncInfo->_errRate +
+                         (1.0 - ERR_RATE_DECAY) * numErrors / numSyncs;
+}
+
+// the wait, and the window the measurement should fit into - the wait
+// ends at the start time, or err later if the sync failed
+void CMSB::sync_trace (CMSB::TimeSyncInfo* syncInfo, double enterTime, double startTime, double err) {
+
+    CMSB::trace_event ((err > 0) ? "sync_miss" : "sync_wait", "sync", enterTime,
+                       (err > 0) ? startTime + err : startTime);
+    CMSB::trace_event ("sync_window", "sync", startTime, startTime + syncInfo->_window);
+}
+
+// converts a local time to rank 0's time with the current clock model
+double CMSB::sync_local_to_global (double localTime) {
+
+    return localTime + gdiff + gskew*(localTime-gepoch);
+}
+
+// frees the node split - the next sync_init_stage1 builds it again
+void CMSB::sync_finalize (CMSB::TimeSyncInfo* syncInfo) {
 
-    gnext= gnext - gdiff;   // adjust rank 0's time to local time
+    if (syncInfo->_nodeComm != MPI_COMM_NULL) {
+        MPI_Comm_free (&syncInfo->_nodeComm);
+    }
+    if (syncInfo->_leaderComm != MPI_COMM_NULL) {
+        MPI_Comm_free (&syncInfo->_leaderComm);
+    }
 }
 
 
 static volatile int NBC_Dummy_var=0; /* avoid optimizations */
 
+#define SLEEP_MARGIN 200e-6     // stop sleeping this many seconds before the
+                                // start time - the rest is spent spinning
+
+/* tells the core we are spinning - frees resources for a hyperthread sibling */
+static inline void cpu_relax () {
+#if defined (__x86_64__) || defined (__i386__)
+    asm volatile ("pause" ::: "memory");
+#elif defined (__powerpc__)
+    asm volatile ("or 27,27,27" ::: "memory");  // low thread priority
+    asm volatile ("or 2,2,2" ::: "memory");     // back to medium priority
+#else
+    NBC_Dummy_var++;
+#endif
+}
+
 // for every single measurement
 double CMSB::nbcb_sync (CMSB::TimeSyncInfo* syncInfo) {
   
     double err = 0;
+    double tnext;
+    double tenter = elg_pform_wtime ();
  
     // OMPI does not send messages immediately!!!! -> drain messages
-    MPI_Barrier(syncInfo->_comm);
+    if (syncInfo->_waitMode == CMSB::SYNC_WAIT_RELAXED) {
+#if MPI_VERSION >= 3
+        // without blocking progress of the MPI library
+        MPI_Request req;
+        int flag = 0;
+        MPI_Ibarrier (syncInfo->_comm, &req);
+        do {
+            cpu_relax ();
+            MPI_Test (&req, &flag, MPI_STATUS_IGNORE);
+        } while (!flag);
+#else
+        MPI_Barrier (syncInfo->_comm);
+#endif
+    } else {
+        MPI_Barrier (syncInfo->_comm);
+    }
 
-    if (elg_pform_wtime () > gnext) {
-        err = elg_pform_wtime ()-gnext;
+    tnext = global_to_local (gnext);    // adjust rank 0's time to local time
+    tnext += syncInfo->_arrivalDelay;   // injected late arrival of this rank
+    if (elg_pform_wtime () > tnext) {
+        err = elg_pform_wtime ()-tnext;
+    } else if (syncInfo->_waitMode == CMSB::SYNC_WAIT_RELAXED) {
+        // sleep through long waits, spin politely through the rest
+        double wait = tnext - elg_pform_wtime () - SLEEP_MARGIN;
+        if (wait > 0) {
+            struct timespec ts;
+            ts.tv_sec = (time_t)wait;
+            ts.tv_nsec = (long)((wait - ts.tv_sec) * 1e9);
+            nanosleep (&ts, NULL);
+        }
+        while (elg_pform_wtime () < tnext) {cpu_relax ();};
     } else {
         // wait
-        while (elg_pform_wtime () < gnext) {NBC_Dummy_var++;};
+        while (elg_pform_wtime () < tnext) {NBC_Dummy_var++;};
     }
   
+    // traced by sync_trace once the measurement is done
+    syncInfo->_syncEnter = tenter;
+    syncInfo->_syncStart = tnext;
+
     gnext = gnext + syncInfo->_window;
     
     return err;
@@ -18,25 +18,63 @@
 //#define SYNC_WINDOW
 //#define SYNC_BARRIER
 
+/* SYNC_WINDOW: synchronize every rank on its own instead of one leader per
+ * shared-memory node (for nodes whose cores do not share a clock) */
+//#define SYNC_FLAT_TREE
+
 
 namespace CMSB {
+
+    /* how nbcb_sync waits for the start of the next measurement */
+    enum SyncWaitMode {
+        SYNC_WAIT_SPIN,     /* MPI_Barrier, then busy loop on the clock */
+        SYNC_WAIT_RELAXED   /* MPI_Ibarrier + test loop, then sleep and spin with pause hints */
+    };
     
     struct TimeSyncInfo {
 
         TimeSyncInfo () :
             _comm    (MPI_COMM_WORLD),
             _esttime (0.0),
-            _window  (0.0) {
+            _window  (0.0),
+            _errRate (0.0),
+            _roundsSinceSync (0),
+            _waitMode (SYNC_WAIT_SPIN),
+            _arrivalDelay (0.0),
+            _armedWindow (0.0),
+            _bcastTime (0.0),
+            _syncEnter (0.0),
+            _syncStart (0.0),
+            _nodeComm (MPI_COMM_NULL),
+            _leaderComm (MPI_COMM_NULL) {
         }
         
+        /* _esttime and _window have to be the same on all ranks of _comm -
+         * sync_init_stage2 decides locally whether to re-arm from them */
         MPI_Comm _comm;
         double _esttime; /* estimated maximum single step time (=max(estnbctime, estmpitime)) in usec */
         double _window; 	/* window to perform operation */
+        double _errRate;    /* smoothed fraction of failed syncs per round - triggers re-sync */
+        int _roundsSinceSync;   /* rounds armed since the last clock sync epoch */
+        SyncWaitMode _waitMode;
+        double _arrivalDelay;   /* this rank starts this many seconds after the others */
+        double _armedWindow;    /* window _bcastTime was measured for */
+        double _bcastTime;      /* cached maximum bcast time on _comm - only valid on rank 0 */
+        double _syncEnter;      /* local time the last nbcb_sync was entered */
+        double _syncStart;      /* local start time it waited for */
+        MPI_Comm _nodeComm;     /* ranks of _comm sharing our clock - built by sync_init_stage1 */
+        MPI_Comm _leaderComm;   /* one rank per node - only valid on the node leaders */
     };
 
     void sync_init_stage1 (CMSB::TimeSyncInfo* syncInfo);
     void sync_init_stage2 (CMSB::TimeSyncInfo* syncInfo);
     double nbcb_sync (CMSB::TimeSyncInfo* syncInfo);
+    void sync_report_errors (CMSB::TimeSyncInfo* syncInfo, int numErrors, int numSyncs);
+    /* traces a sync from the _syncEnter and _syncStart it left behind -
+     * after the measurement, so tracing does not delay it */
+    void sync_trace (CMSB::TimeSyncInfo* syncInfo, double enterTime, double startTime, double err);
+    double sync_local_to_global (double localTime);
+    void sync_finalize (CMSB::TimeSyncInfo* syncInfo);
 }
 
 #endif
@@ -0,0 +1,231 @@
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "elg_pform_defs.h"
+#include "ClockSync.h"
+#include "EventTrace.h"
+
+
+#define MAX_TRACE_EVENTS 32768  // per rank - later events are dropped
+
+struct TraceEvent {
+    int name;       // index into trace_names
+    int cat;        // index into trace_names
+    double start;   // usec since trace_origin in rank 0's time
+    double dur;     // usec
+};
+
+static TraceEvent* trace_events = NULL;     // NULL while not recording
+static std::vector<std::string> trace_names;    // names and categories of the events
+static int num_trace_events = 0;
+static int num_dropped_events = 0;
+static double trace_origin = 0;             // rank 0's time at trace_init
+static int trace_node = 0;                  // rank of our node leader
+static MPI_Comm trace_comm = MPI_COMM_NULL;
+static char trace_file[256];
+
+
+void CMSB::trace_init (MPI_Comm comm, const char* fileName) {
+
+    int r;
+    MPI_Comm node_comm;
+
+    if (trace_events != NULL) return;
+
+    MPI_Comm_dup (comm, &trace_comm);
+    MPI_Comm_rank (trace_comm, &r);
+    std::strncpy (trace_file, fileName, sizeof (trace_file)-1);
+    trace_file[sizeof (trace_file)-1] = '\0';
+
+    trace_events = new TraceEvent[MAX_TRACE_EVENTS];
+    trace_names.clear ();
+    num_trace_events = 0;
+    num_dropped_events = 0;
+
+    trace_origin = CMSB::sync_local_to_global (CMSB::elg_pform_wtime ());
+    MPI_Bcast (&trace_origin, 1, MPI_DOUBLE, 0, trace_comm);
+
+    // the ranks of a node are grouped under their leader's rank
+#if MPI_VERSION >= 3
+    MPI_Comm_split_type (trace_comm, MPI_COMM_TYPE_SHARED, r, MPI_INFO_NULL, &node_comm);
+#else
+    MPI_Comm_split (trace_comm, r, 0, &node_comm);
+#endif
+    trace_node = r;
+    MPI_Bcast (&trace_node, 1, MPI_INT, 0, node_comm);
+    MPI_Comm_free (&node_comm);
+}
+
+
+/* index of a name in trace_names, added if new - the few names of the
+ * syncs come first and are found right away */
+static int trace_name_index (const char* name) {
+
+    int i, n = trace_names.size ();
+
+    for (i=0; i<n; i++) {
+        if (std::strcmp (trace_names[i].c_str (), name) == 0) return i;
+    }
+    trace_names.push_back (name);
+    return n;
+}
+
+
+void CMSB::trace_event (const char* name, const char* category, double startTime, double endTime) {
+
+    TraceEvent* ev;
+
+    if (trace_events == NULL) return;
+    if (num_trace_events == MAX_TRACE_EVENTS) {
+        num_dropped_events++;
+        return;
+    }
+
+    ev = &trace_events[num_trace_events++];
+    ev->name = trace_name_index (name);
+    ev->cat = trace_name_index (category);
+    ev->start = (CMSB::sync_local_to_global (startTime) - trace_origin) * 1e6;
+    ev->dur = (endTime - startTime) * 1e6;
+}
+
+
+/* writes a name as a JSON string - quotes, backslashes and control
+ * characters escaped */
+static void write_json_string (FILE* f, const char* str) {
+
+    fputc ('"', f);
+    for (; *str != '\0'; str++) {
+        unsigned char c = *str;
+        if (c == '"' || c == '\\') fprintf (f, "\\%c", c);
+        else if (c < 0x20) fprintf (f, "\\u%04x", c);
+        else fputc (c, f);
+    }
+    fputc ('"', f);
+}
+
+
+static void write_trace_events (FILE* f, int rank, int node, const TraceEvent* events, int numEvents,
+                                const std::vector<const char*>& names) {
+
+    int i;
+
+    // name the track of the rank
+    fprintf (f, ",\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"node of rank %d\"}}",
+             node, node);
+    fprintf (f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"rank %d\"}}",
+             node, rank, rank);
+    for (i=0; i<numEvents; i++) {
+        fprintf (f, ",\n{\"name\":");
+        write_json_string (f, names[events[i].name]);
+        fprintf (f, ",\"cat\":");
+        write_json_string (f, names[events[i].cat]);
+        fprintf (f, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d}",
+                 events[i].start, events[i].dur, node, rank);
+    }
+}
+
+
+/* the names as consecutive '\0'-terminated strings, ended by an empty
+ * one, and back */
+static void pack_trace_names (std::vector<char>& buff) {
+
+    unsigned int i;
+
+    buff.clear ();
+    for (i=0; i<trace_names.size (); i++) {
+        buff.insert (buff.end (), trace_names[i].c_str (), trace_names[i].c_str () + trace_names[i].size () + 1);
+    }
+    buff.push_back ('\0');
+}
+
+static void unpack_trace_names (const std::vector<char>& buff, std::vector<const char*>& names) {
+
+    unsigned int i;
+
+    names.clear ();
+    for (i=0; buff[i] != '\0'; i += std::strlen (&buff[i]) + 1) {
+        names.push_back (&buff[i]);
+    }
+}
+
+
+void CMSB::trace_write () {
+
+    int r, p, src, file_ok = 0, total_dropped = 0;
+    int header[3];  // number of events, node, bytes of the names
+    std::vector<char> name_buff;
+    std::vector<const char*> names;
+    FILE* f = NULL;
+
+    if (trace_events == NULL) return;
+
+    MPI_Comm_rank (trace_comm, &r);
+    MPI_Comm_size (trace_comm, &p);
+
+    if (r == 0) {
+        f = fopen (trace_file, "w");
+        file_ok = (f != NULL);
+        if (!file_ok) {
+            std::cerr << "Cannot open trace file " << trace_file << std::endl;
+        }
+    }
+    MPI_Bcast (&file_ok, 1, MPI_INT, 0, trace_comm);
+
+    if (file_ok) {
+        if (r == 0) {
+            fprintf (f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+            fprintf (f, "{\"name\":\"trace\",\"ph\":\"M\",\"pid\":0,\"args\":{\"ranks\":%d}}", p);
+            pack_trace_names (name_buff);
+            unpack_trace_names (name_buff, names);
+            write_trace_events (f, 0, trace_node, trace_events, num_trace_events, names);
+
+            /* fetch the events rank by rank into our own (written) buffer -
+             * rank 0 never holds more than one rank's events */
+            for (src=1; src<p; src++) {
+                MPI_Send (&file_ok, 1, MPI_INT, src, 0, trace_comm);
+                MPI_Recv (header, 3, MPI_INT, src, 0, trace_comm, MPI_STATUS_IGNORE);
+                name_buff.resize (header[2]);
+                MPI_Recv (&name_buff[0], header[2], MPI_CHAR, src, 0, trace_comm, MPI_STATUS_IGNORE);
+                unpack_trace_names (name_buff, names);
+                MPI_Recv (trace_events, header[0] * sizeof (TraceEvent), MPI_BYTE, src, 0,
+                          trace_comm, MPI_STATUS_IGNORE);
+                write_trace_events (f, src, header[1], trace_events, header[0], names);
+            }
+            fprintf (f, "\n]}\n");
+            fclose (f);
+        }
+        else {
+            MPI_Recv (&file_ok, 1, MPI_INT, 0, 0, trace_comm, MPI_STATUS_IGNORE);
+            pack_trace_names (name_buff);
+            header[0] = num_trace_events;
+            header[1] = trace_node;
+            header[2] = name_buff.size ();
+            MPI_Send (header, 3, MPI_INT, 0, 0, trace_comm);
+            MPI_Send (&name_buff[0], header[2], MPI_CHAR, 0, 0, trace_comm);
+            MPI_Send (trace_events, num_trace_events * sizeof (TraceEvent), MPI_BYTE, 0, 0, trace_comm);
+        }
+    }
+
+    MPI_Reduce (&num_dropped_events, &total_dropped, 1, MPI_INT, MPI_SUM, 0, trace_comm);
+    if (r == 0 && total_dropped > 0) {
+        std::cout << "Event trace: " << total_dropped << " events dropped - buffer of "
+                  << MAX_TRACE_EVENTS << " events per rank full" << std::endl;
+    }
+
+    delete[] trace_events;
+    trace_events = NULL;
+    trace_names.clear ();
+    MPI_Comm_free (&trace_comm);
+}
+
+
+unsigned int CMSB::trace_get_mem_consumption () {
+
+    unsigned int i, mem = 0;
+
+    if (trace_events == NULL) return 0;
+    for (i=0; i<trace_names.size (); i++) mem += trace_names[i].capacity () + 1;
+    return MAX_TRACE_EVENTS * sizeof (TraceEvent) + trace_names.capacity () * sizeof (std::string) + mem;
+}
@@ -0,0 +1,28 @@
+#ifndef __EVENT_TRACE_H__
+#define __EVENT_TRACE_H__
+
+
+#include <mpi.h>
+
+
+namespace CMSB {
+
+    /* Records per-rank events in rank 0's time and merges them into one
+     * Chrome Trace Event file (also read by Perfetto) with one track per
+     * rank. Recording is a no-op until trace_init was called. */
+
+    /* starts recording - collective over comm */
+    void trace_init (MPI_Comm comm, const char* fileName);
+
+    /* records an event between two local times (elg_pform_wtime) */
+    void trace_event (const char* name, const char* category, double startTime, double endTime);
+
+    /* writes the events of all ranks to the file and stops recording -
+     * collective over the comm given to trace_init */
+    void trace_write ();
+
+    /* bytes held by the event buffer */
+    unsigned int trace_get_mem_consumption ();
+}
+
+#endif
@@ -0,0 +1,56 @@
+#include "SyncRounds.h"
+
+
+CMSB::SyncRounds::SyncRounds (MPI_Comm comm, CMSB::TimeSyncInfo* syncInfo, int roundIters, int totalIters)
+    : _comm (comm), _syncInfo (syncInfo), _roundIters (roundIters), _totalIters (totalIters),
+      _numKept (0), _numErrors (0), _numSyncs (0),
+      _errors (roundIters, 0.0), _maxErrors (roundIters, 0.0),
+      _enterTimes (roundIters, 0.0), _startTimes (roundIters, 0.0) {
+}
+
+
+bool CMSB::SyncRounds::nextRound () {
+
+    _numKept += _keptIters.size ();
+    _keptIters.clear ();
+    if (_numKept >= _totalIters) return false;
+    CMSB::sync_init_stage2 (_syncInfo);
+    return true;
+}
+
+
+void CMSB::SyncRounds::sync (int iter) {
+
+    _errors[iter] = CMSB::nbcb_sync (_syncInfo);
+    _enterTimes[iter] = _syncInfo->_syncEnter;
+    _startTimes[iter] = _syncInfo->_syncStart;
+}
+
+
+bool CMSB::SyncRounds::endRound () {
+
+    for (int i = 0; i < _roundIters; i++) {
+        CMSB::sync_trace (_syncInfo, _enterTimes[i], _startTimes[i], _errors[i]);
+    }
+
+    // An iteration counts only if its sync succeeded on all ranks
+    MPI_Allreduce (&_errors[0], &_maxErrors[0], _roundIters, MPI_DOUBLE, MPI_MAX, _comm);
+    int num_errors = 0;
+    for (int i = 0; i < _roundIters; i++) {
+        if (_maxErrors[i] > 0.0) num_errors++;
+    }
+    CMSB::sync_report_errors (_syncInfo, num_errors, _roundIters);
+    _numSyncs += _roundIters;
+    _numErrors += num_errors;
+
+    // If more than 25% errors occured or there are less than 4 valid
+    // measurements, the window is doubled and the round re-run
+    if (num_errors > _roundIters*0.25 || _roundIters - num_errors < 4) {
+        _syncInfo->_window *= 2.0;
+        return false;
+    }
+    for (int i = 0; i < _roundIters && _numKept + int (_keptIters.size ()) < _totalIters; i++) {
+        if (_maxErrors[i] <= 0.0) _keptIters.push_back (i);
+    }
+    return true;
+}
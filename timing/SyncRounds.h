@@ -0,0 +1,54 @@
+#ifndef __SYNC_ROUNDS_H__
+#define __SYNC_ROUNDS_H__
+
+
+#include <mpi.h>
+#include <vector>
+#include "ClockSync.h"
+
+
+namespace CMSB {
+
+    /* The synchronized iterations of a measurement in rounds. A round
+     * with more than 25% failed syncs (on any rank of comm) is repeated
+     * with twice the window, the others keep their iterations with a
+     * successful sync until totalIters are kept. Collective over comm. */
+    class SyncRounds {
+    public:
+
+        SyncRounds (MPI_Comm comm, CMSB::TimeSyncInfo* syncInfo, int roundIters, int totalIters);
+
+        /* starts the next round - false once enough iterations are kept */
+        bool nextRound ();
+        /* waits for the slot of the given iteration of the round */
+        void sync (int iter);
+        /* checks and traces the syncs of the round - false if it has to
+         * be repeated */
+        bool endRound ();
+
+        /* iterations of the round that are kept, in order */
+        const std::vector<int>& getKeptIters () const { return _keptIters; }
+        /* iterations kept in the rounds before */
+        int getNumKept () const { return _numKept; }
+        int getNumErrors () const { return _numErrors; }
+        int getNumSyncs () const { return _numSyncs; }
+
+    private:
+        MPI_Comm            _comm;
+        CMSB::TimeSyncInfo* _syncInfo;
+        int                 _roundIters;
+        int                 _totalIters;
+        int                 _numKept;
+        int                 _numErrors;
+        int                 _numSyncs;
+        std::vector<double> _errors;
+        std::vector<double> _maxErrors;
+        std::vector<double> _enterTimes;
+        std::vector<double> _startTimes;
+        std::vector<int>    _keptIters;
+    };
+
+}
+
+
+#endif   // __SYNC_ROUNDS_H__
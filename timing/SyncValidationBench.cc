@@ -0,0 +1,140 @@
+#include <cmath>
+#include <iostream>
+#include <ios>
+#include <iomanip>
+#include <vector>
+#include "elg_pform_defs.h"
+#include "SyncValidationBench.h"
+
+
+const double CMSB::SyncValidationBench::WARN_LATENCY_FRACTION = 0.25;
+
+
+CMSB::SyncValidationBench::SyncValidationBench ()
+    : _myRank (0), _numProcs (0), _numChecks (0), _maxResidual (0.0) {
+}
+
+
+CMSB::SyncValidationBench::~SyncValidationBench () {
+}
+
+
+void CMSB::SyncValidationBench::init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo) {
+
+    CMSB::MicroBench::init (worldComm, benchInfo);
+}
+
+
+void CMSB::SyncValidationBench::runMicroBench (CMSB::TimeSyncInfo* syncInfo) {
+
+    // The clocks are synchronized on the sync communicator
+    MPI_Comm comm = syncInfo->_comm;
+    MPI_Comm_rank (comm, &_myRank);
+    MPI_Comm_size (comm, &_numProcs);
+
+    std::vector<int> peers;
+    getSamplePeers (syncInfo, peers);
+
+    _maxResidual = 0.0;
+    for (size_t i = 0; i < peers.size (); i++) {
+        int peer = peers[i];
+        if (_myRank != 0 && _myRank != peer) continue;
+
+        double residual, latency;
+        measureResidual (comm, peer, &residual, &latency);
+        if (_myRank != 0) continue;
+
+        double now = CMSB::sync_local_to_global (CMSB::elg_pform_wtime ());
+        std::cout << getMicroBenchName () << ": check " << _numChecks << ", rank " << peer
+                  << ": residual = " << std::setprecision(6) << std::fixed << residual
+                  << ", latency = " << std::setprecision(6) << std::fixed << latency;
+        if (_numChecks > 0) {
+            // Drift of the residual since the previous check in usec per second
+            double drift = (residual - _lastResiduals[i]) / (now - _lastTimes[i]);
+            std::cout << ", drift = " << std::setprecision(6) << std::fixed << drift;
+        }
+        std::cout << std::endl;
+        if (std::fabs (residual) > WARN_LATENCY_FRACTION * latency) {
+            std::cout << getMicroBenchName () << ": WARNING: residual error to rank " << peer
+                      << " exceeds " << std::setprecision(2) << std::fixed
+                      << WARN_LATENCY_FRACTION << " of the latency" << std::endl;
+        }
+
+        _lastTimes[i] = now;
+        _lastResiduals[i] = residual;
+        if (std::fabs (residual) > _maxResidual) _maxResidual = std::fabs (residual);
+    }
+
+    if (_myRank == 0) {
+        std::cout << getMicroBenchName () << ": check " << _numChecks << ", max residual = "
+                  << std::setprecision(6) << std::fixed << _maxResidual << std::endl;
+    }
+    _numChecks++;
+}
+
+
+void CMSB::SyncValidationBench::getSamplePeers (CMSB::TimeSyncInfo* syncInfo, std::vector<int>& peers) {
+
+    // The sync tree only connects the node leaders - the other ranks take
+    // the clock model of their leader, so the leaders are the ranks to
+    // check. On a single node they fall back to strided ranks.
+    int is_leader = (syncInfo->_leaderComm != MPI_COMM_NULL);
+    std::vector<int> leaders (_numProcs);
+    MPI_Allgather (&is_leader, 1, MPI_INT, &leaders[0], 1, MPI_INT, syncInfo->_comm);
+
+    std::vector<int> candidates;
+    for (int r = 1; r < _numProcs; r++) {
+        if (leaders[r]) candidates.push_back (r);
+    }
+    if (candidates.empty ()) {
+        for (int r = 1; r < _numProcs; r++) candidates.push_back (r);
+    }
+
+    int num_candidates = candidates.size ();
+    int stride = num_candidates / NUM_SAMPLES;
+    if (stride < 1) stride = 1;
+
+    peers.clear ();
+    for (int i = 0; i < NUM_SAMPLES && i*stride < num_candidates; i++) {
+        peers.push_back (candidates[i*stride]);
+    }
+}
+
+
+void CMSB::SyncValidationBench::measureResidual (MPI_Comm comm, int peer, double* residual, double* latency) {
+
+    // Rank 0 is the client of the ping-pong, the sampled rank the server.
+    // Both use their corrected clocks, so the measured difference is the
+    // error left after the synchronization. A zero time stops the server.
+    double tstart, tend, trem, smallest = 1e99;
+    int not_smaller = 0;
+
+    *residual = 0.0;
+    *latency = 0.0;
+    do {
+        if (_myRank == 0) {
+            tstart = CMSB::sync_local_to_global (CMSB::elg_pform_wtime ());
+            MPI_Send (&tstart, 1, MPI_DOUBLE, peer, 0, comm);
+            MPI_Recv (&trem, 1, MPI_DOUBLE, peer, 0, comm, MPI_STATUS_IGNORE);
+            tend = CMSB::sync_local_to_global (CMSB::elg_pform_wtime ());
+
+            if (tend - tstart < smallest) {
+                smallest = tend - tstart;
+                not_smaller = 0;
+                *residual = (tstart + (tend - tstart)/2 - trem) * 1e6;    // Convert to usec
+                *latency = smallest/2 * 1e6;
+            }
+            else if (++not_smaller == NUM_NOT_SMALLER) {
+                trem = 0;
+                MPI_Send (&trem, 1, MPI_DOUBLE, peer, 0, comm);
+                break;
+            }
+        }
+        else {
+            MPI_Recv (&tstart, 1, MPI_DOUBLE, 0, 0, comm, MPI_STATUS_IGNORE);
+            if (tstart == 0) break;
+            trem = CMSB::sync_local_to_global (CMSB::elg_pform_wtime ());
+            MPI_Send (&trem, 1, MPI_DOUBLE, 0, 0, comm);
+        }
+    } while (1);
+}
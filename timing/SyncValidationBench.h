@@ -0,0 +1,59 @@
+#ifndef __SYNC_VALIDATION_BENCH_H__
+#define __SYNC_VALIDATION_BENCH_H__
+
+
+#include <mpi.h>
+#include <vector>
+#include <MicroBench.h>
+
+
+namespace CMSB {
+
+    /**
+     * Checks the accuracy of the clock synchronization. Rank 0 estimates
+     * the difference of its corrected clock to the corrected clocks of a
+     * sample of ranks with a fresh ping-pong. Repeated runs report how
+     * the residual error drifts over the campaign.
+     */
+    class SyncValidationBench : public CMSB::MicroBench {
+    public:
+
+        // Number of ranks rank 0 checks its clock against - node leaders
+        // if the ranks span several nodes
+        static const int NUM_SAMPLES = 16;
+
+        // Ping-pong until this many successive RTTs are not smaller
+        // than the current smallest one
+        static const int NUM_NOT_SMALLER = 100;
+
+        // Number of benchmarks to run between two checks
+        static const int CHECK_INTERVAL = 4;
+
+        // Warn if the residual error exceeds this fraction of the latency
+        static const double WARN_LATENCY_FRACTION;
+
+        SyncValidationBench ();
+        virtual ~SyncValidationBench ();
+
+        virtual void init (MPI_Comm worldComm, CMSB::MicroBench::MicroBenchInfo* benchInfo);
+        virtual void runMicroBench (CMSB::TimeSyncInfo* syncInfo);
+		virtual const char* getMicroBenchName  () const { return "ClockSyncValidation"; }
+		virtual double getMicroBenchResult     () const { return _maxResidual; }
+		virtual void writeResultToProfile      () const { }
+		virtual unsigned int getMemConsumption () const { return sizeof (CMSB::SyncValidationBench); }
+
+    protected:
+        void getSamplePeers (CMSB::TimeSyncInfo* syncInfo, std::vector<int>& peers);
+        void measureResidual (MPI_Comm comm, int peer, double* residual, double* latency);
+
+        int     _myRank;
+        int     _numProcs;
+        int     _numChecks;
+        double  _maxResidual;                   // In usec
+        double  _lastTimes[NUM_SAMPLES];        // Global time of the previous check
+        double  _lastResiduals[NUM_SAMPLES];    // In usec
+    };
+
+}
+
+#endif      // __SYNC_VALIDATION_BENCH_H__
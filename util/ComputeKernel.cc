@@ -0,0 +1,53 @@
+#include <timing/elg_pform_defs.h>
+#include "ComputeKernel.h"
+
+
+#define MAX_DOUBLE 1e99
+#define MAX_CALIBRATION_TIME 1e-3      // Grow the calibration work up to this many seconds
+
+
+CMSB::ComputeKernel::ComputeKernel ()
+    : _sink (1.0) {
+}
+
+
+void CMSB::ComputeKernel::run (unsigned int numUnits) {
+
+    // A dependent chain the compiler can neither vectorize nor drop
+    double x = _sink;
+    for (unsigned int i = 0; i < numUnits; i++) {
+        x = x * 0.999999 + 1e-6;
+    }
+    _sink = x;
+}
+
+
+double CMSB::ComputeKernel::time (unsigned int numUnits, int numRuns) {
+
+    double min_time = MAX_DOUBLE;
+    for (int i = 0; i < numRuns; i++) {
+        double start_time = CMSB::elg_pform_wtime ();
+        run (numUnits);
+        double t = CMSB::elg_pform_wtime () - start_time;
+        if (t < min_time) min_time = t;
+    }
+    return min_time;
+}
+
+
+unsigned int CMSB::ComputeKernel::calibrate (double seconds) {
+
+    unsigned int units = 1000;
+    double min_time;
+
+    // Double the work until it is long enough to be timed, the fastest
+    // of a few runs is the noise-free time
+    for (;;) {
+        min_time = time (units, 5);
+        if (min_time > MAX_CALIBRATION_TIME || units >= (1U << 30)) break;
+        units *= 2;
+    }
+
+    double scaled = units * seconds / min_time;
+    return (scaled < 1.0) ? 1 : (unsigned int)scaled;
+}
@@ -0,0 +1,31 @@
+#ifndef __COMPUTE_KERNEL_H__
+#define __COMPUTE_KERNEL_H__
+
+
+namespace CMSB {
+
+    /**
+     * A calibrated piece of pure computation without memory traffic - the
+     * fixed work of the noise measurement and the computation overlapped
+     * with the nonblocking collectives.
+     */
+    class ComputeKernel {
+    public:
+
+        ComputeKernel ();
+
+        // Runs numUnits units of the kernel
+        void run (unsigned int numUnits);
+        // Time of the fastest of numRuns runs in sec
+        double time (unsigned int numUnits, int numRuns);
+        // Units that take about this many seconds without noise
+        unsigned int calibrate (double seconds);
+
+    private:
+        double _sink;       // Keeps the kernel from being optimized away
+    };
+
+}
+
+
+#endif   // __COMPUTE_KERNEL_H__
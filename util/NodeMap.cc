@@ -0,0 +1,21 @@
+#include "NodeMap.h"
+
+
+void CMSB::gatherRankNodes (MPI_Comm comm, std::vector<int>& rankNodes) {
+
+    int my_rank, num_procs;
+    MPI_Comm_rank (comm, &my_rank);
+    MPI_Comm_size (comm, &num_procs);
+
+    MPI_Comm node_comm;
+    int node = my_rank;
+#if MPI_VERSION >= 3
+    MPI_Comm_split_type (comm, MPI_COMM_TYPE_SHARED, my_rank, MPI_INFO_NULL, &node_comm);
+#else
+    MPI_Comm_split (comm, my_rank, 0, &node_comm);
+#endif
+    MPI_Bcast (&node, 1, MPI_INT, 0, node_comm);
+    MPI_Comm_free (&node_comm);
+    rankNodes.resize ((my_rank == 0) ? num_procs : 0);
+    MPI_Gather (&node, 1, MPI_INT, (my_rank == 0) ? &rankNodes[0] : NULL, 1, MPI_INT, 0, comm);
+}
@@ -0,0 +1,18 @@
+#ifndef __NODE_MAP_H__
+#define __NODE_MAP_H__
+
+
+#include <mpi.h>
+#include <vector>
+
+
+namespace CMSB {
+
+    // Node of each rank of comm on its rank 0, the others get an empty
+    // vector - the nodes are named after the rank of their leader
+    void gatherRankNodes (MPI_Comm comm, std::vector<int>& rankNodes);
+
+}
+
+
+#endif   // __NODE_MAP_H__
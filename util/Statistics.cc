@@ -0,0 +1,10 @@
+#include <algorithm>
+#include "Statistics.h"
+
+
+double CMSB::median (std::vector<double>& values) {
+
+    std::sort (values.begin (), values.end ());
+    int n = values.size ();
+    return (n % 2 > 0) ? values[n/2] : (values[n/2 - 1] + values[n/2]) / 2;
+}
@@ -0,0 +1,16 @@
+#ifndef __STATISTICS_H__
+#define __STATISTICS_H__
+
+
+#include <vector>
+
+
+namespace CMSB {
+
+    // Median of the values - reorders them
+    double median (std::vector<double>& values);
+
+}
+
+
+#endif   // __STATISTICS_H__
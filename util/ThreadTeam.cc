@@ -0,0 +1,72 @@
+#include <sched.h>
+#include "ThreadTeam.h"
+
+
+CMSB::ThreadTeam::ThreadTeam ()
+    : _numThreads (1), _func (NULL), _arg (NULL), _startGen (0), _numDone (0), _stop (1) {
+}
+
+
+CMSB::ThreadTeam::~ThreadTeam () {
+
+    stop ();
+}
+
+
+void CMSB::ThreadTeam::start (int numThreads, Func func, void* arg) {
+
+    stop ();
+    _numThreads = numThreads;
+    _func = func;
+    _arg = arg;
+    _startGen = 0;
+    _numDone = 0;
+    _stop = 0;
+    _threads.resize (_numThreads);
+    _threadArgs.resize (_numThreads);
+    for (int t = 1; t < _numThreads; t++) {
+        _threadArgs[t]._team = this;
+        _threadArgs[t]._thread = t;
+        pthread_create (&_threads[t], NULL, threadMain, &_threadArgs[t]);
+    }
+}
+
+
+void CMSB::ThreadTeam::run () {
+
+    if (_numThreads > 1) {
+        __atomic_store_n (&_numDone, 0, __ATOMIC_RELAXED);
+        __atomic_fetch_add (&_startGen, 1, __ATOMIC_RELEASE);
+    }
+    _func (_arg, 0);
+    while (__atomic_load_n (&_numDone, __ATOMIC_ACQUIRE) < _numThreads-1) sched_yield ();
+}
+
+
+void CMSB::ThreadTeam::stop () {
+
+    if (_stop) return;
+    __atomic_store_n (&_stop, 1, __ATOMIC_RELEASE);
+    for (int t = 1; t < _numThreads; t++) {
+        pthread_join (_threads[t], NULL);
+    }
+    _threads.clear ();
+}
+
+
+void* CMSB::ThreadTeam::threadMain (void* args) {
+
+    CMSB::ThreadTeam* team = ((ThreadArgs*)args)->_team;
+    int thread = ((ThreadArgs*)args)->_thread;
+    int gen = 0;
+    while (true) {
+        int next_gen;
+        while ((next_gen = __atomic_load_n (&team->_startGen, __ATOMIC_ACQUIRE)) == gen
+               && !__atomic_load_n (&team->_stop, __ATOMIC_ACQUIRE)) sched_yield ();
+        if (__atomic_load_n (&team->_stop, __ATOMIC_ACQUIRE)) break;
+        gen = next_gen;
+        team->_func (team->_arg, thread);
+        __atomic_fetch_add (&team->_numDone, 1, __ATOMIC_RELEASE);
+    }
+    return NULL;
+}
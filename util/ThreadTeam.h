@@ -0,0 +1,56 @@
+#ifndef __THREAD_TEAM_H__
+#define __THREAD_TEAM_H__
+
+
+#include <pthread.h>
+#include <vector>
+
+
+namespace CMSB {
+
+    /**
+     * Threads that run a function together whenever the calling thread
+     * asks for it. The caller is thread 0, the others spin (yielding the
+     * core) between the runs so that they enter the function right away.
+     */
+    class ThreadTeam {
+    public:
+
+        // Called by every thread of a run with the thread number
+        typedef void (*Func) (void* arg, int thread);
+
+        ThreadTeam ();
+        ~ThreadTeam ();
+
+        // Creates numThreads-1 threads - they run func until stop
+        void start (int numThreads, Func func, void* arg);
+        // Runs func on all threads, returns once all of them are done
+        void run ();
+        void stop ();
+
+    private:
+        struct ThreadArgs {
+            CMSB::ThreadTeam*   _team;
+            int                 _thread;
+        };
+
+        static void* threadMain (void* args);
+
+        int                     _numThreads;
+        Func                    _func;
+        void*                   _arg;
+        std::vector<pthread_t>  _threads;
+        std::vector<ThreadArgs> _threadArgs;
+        // The caller bumps the generation to start a run, the others
+        // count themselves done - accessed with __atomic acquire loads
+        // and release stores, so that a run sees the caller's writes
+        // and the caller sees the results of the run
+        int                     _startGen;
+        int                     _numDone;
+        int                     _stop;
+    };
+
+}
+
+
+#endif   // __THREAD_TEAM_H__